@@ -0,0 +1,7 @@
+// Written once per pass, see UniformBlocks::Camera, which this must match.
+layout(std140) uniform Camera {
+    mat4 u_view_matrix;
+    mat4 u_projection_matrix;
+    // w is unused.
+    vec4 u_camera_position;
+};
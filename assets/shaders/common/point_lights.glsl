@@ -0,0 +1,19 @@
+// Written once per frame, see UniformBlocks::PointLights, which this must match.
+struct PointLight {
+    vec3 position;
+    float intensity;
+    vec3 colour;
+
+    float constant;
+    float linear;
+    float quadratic;
+
+    float ambient_coefficient;
+    float specular_exponent;
+};
+#define MAX_POINT_LIGHTS 10
+
+layout(std140) uniform PointLights {
+    PointLight u_point_lights[MAX_POINT_LIGHTS];
+    int u_point_lights_size;
+};
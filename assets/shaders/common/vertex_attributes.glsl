@@ -0,0 +1,34 @@
+// The vertex attributes, in either of the layouts GpuMesh uploads.
+// Read the normal through vertexNormal() so a shader works with both.
+// Meshes without normals or uvs leave those attributes disabled, they read as zero.
+#ifdef QUANTISED_VERTICES
+
+// snorm16 within the mesh's bounds, a_model_matrix includes the dequantisation back to object space.
+layout(location = 0) in vec3 a_position;
+// snorm16 octahedral encoded.
+layout(location = 1) in vec2 a_norm_octahedral;
+// half floats.
+layout(location = 2) in vec2 a_uv;
+
+vec3 vertexNormal() {
+    vec3 normal = vec3(a_norm_octahedral, 1.0 - abs(a_norm_octahedral.x) - abs(a_norm_octahedral.y));
+    float fold = max(-normal.z, 0.0);
+    normal.x += normal.x >= 0.0 ? -fold : fold;
+    normal.y += normal.y >= 0.0 ? -fold : fold;
+    return normalize(normal);
+}
+
+#else
+
+layout(location = 0) in vec3 a_position;
+layout(location = 1) in vec3 a_norm;
+layout(location = 2) in vec2 a_uv;
+
+vec3 vertexNormal() {
+    return a_norm;
+}
+
+#endif
+
+// one per instance, see MeshRenderer. takes locations 3 to 6.
+layout(location = 3) in mat4 a_model_matrix;
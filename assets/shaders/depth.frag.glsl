@@ -0,0 +1,7 @@
+#version 300
+
+precision highp float;
+
+// depth is written by the fixed function, there is no colour to output.
+void main() {
+}
@@ -6,22 +6,7 @@ out vec4 out_colour;
 in vec3 v_normal;
 in vec3 v_frag_position;
 
-struct PointLight {
-    vec3 position;
-    vec3 colour;
-    float intensity;
-
-    float constant;
-    float linear;
-    float quadratic;
-
-    float ambient_coefficient;
-    float specular_exponent;
-};
-#define MAX_POINT_LIGHTS 10
-
-uniform PointLight u_point_lights[MAX_POINT_LIGHTS];
-uniform float u_point_lights_size;
+#include "common/point_lights.glsl"
 
 vec3 warm_colour = vec3(0.87, 0.0, 0.0);
 vec3 middle_colour = vec3(0.73, 0.0, 0.7);
@@ -32,14 +17,10 @@ float blend_factor = 0.5;
 void main() {
     vec3 normal = normalize(v_normal);
 
-    vec3 colour = vec3(0, 0, 0);
-
-    for(int i = 0; i < int(u_point_lights_size); ++i) {
-        colour = u_point_lights[i].colour * u_point_lights[i].ambient_coefficient * u_point_lights[i].constant * u_point_lights[i].intensity * u_point_lights[i].constant * u_point_lights[i].quadratic * u_point_lights[i].linear * u_point_lights[i].specular_exponent;
-    }
+    vec3 colour;
 
     float diffuse = -1.0;
-    for(int i = 0; i < int(u_point_lights_size); ++i) {
+    for(int i = 0; i < u_point_lights_size; ++i) {
         vec3 light_direction = normalize(u_point_lights[i].position - v_frag_position);
         diffuse = max(dot(normal, light_direction), diffuse);
     }
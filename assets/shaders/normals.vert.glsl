@@ -1,18 +1,14 @@
 #version 300
 precision highp float;
 
-layout(location = 0) in vec3 a_position; 
-layout(location = 1) in vec3 a_norm; 
-layout(location = 2) in vec2 a_uv; 
+#include "common/vertex_attributes.glsl"
 
-uniform mat4 u_model_matrix;
-uniform mat4 u_view_matrix;
-uniform mat4 u_projection_matrix;
+#include "common/camera.glsl"
 
 out vec3 v_normal;
 
 void main() {
-    gl_Position = u_projection_matrix * u_view_matrix * u_model_matrix * vec4(a_position, 1.0);
+    gl_Position = u_projection_matrix * u_view_matrix * a_model_matrix * vec4(a_position, 1.0);
 
-    v_normal = mat3(transpose(inverse(u_model_matrix))) * a_norm;
+    v_normal = mat3(transpose(inverse(a_model_matrix))) * vertexNormal();
 }
\ No newline at end of file
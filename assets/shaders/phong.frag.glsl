@@ -6,22 +6,8 @@ out vec4 out_colour;
 in vec4 v_pos;
 in vec4 v_normal;
 
-struct PointLight {
-    vec3 position;
-    vec3 colour;
-    float intensity;
-
-    float constant;
-    float linear;
-    float quadratic;
-
-    float ambient_coefficient;
-    float specular_exponent;
-};
-#define MAX_POINT_LIGHTS 10
-
-uniform PointLight u_point_lights[MAX_POINT_LIGHTS];
-uniform float u_point_lights_size;
+#include "common/camera.glsl"
+#include "common/point_lights.glsl"
 
 vec3 ComputePhongLighting(PointLight light, vec3 position, vec3 normal) {
     vec3 lightDir = normalize(light.position - position);
@@ -34,7 +20,7 @@ vec3 ComputePhongLighting(PointLight light, vec3 position, vec3 normal) {
     vec3 diffuse = light.intensity * diff * light.colour;
 
     // Specular
-    vec3 viewDir = normalize(-position);
+    vec3 viewDir = normalize(u_camera_position.xyz - position);
     vec3 reflectDir = reflect(-lightDir, normal);
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), light.specular_exponent);
     vec3 specular = light.intensity * spec * light.colour;
@@ -50,7 +36,7 @@ void main() {
     vec3 finalColour = vec3(0.0, 0.0, 0.0);
     vec3 normal = vec3(normalize(v_normal));
 
-    for(int i = 0; i < int(round(u_point_lights_size)); ++i) {
+    for(int i = 0; i < u_point_lights_size; ++i) {
         finalColour += ComputePhongLighting(u_point_lights[i], v_pos.xyz, normal.xyz);
     }
 
@@ -8,12 +8,11 @@ in vec3 v_position[];
 in vec3 v_norm[];
 in vec2 v_uv[];
 
-uniform mat4 u_model_matrix;
-uniform mat4 u_view_matrix;
-uniform mat4 u_projection_matrix;
+#include "common/camera.glsl"
 
 void main() {
-    mat4 mvp = u_projection_matrix * u_view_matrix * u_model_matrix;
+    // the positions are already in world space, see wireframe.vert.glsl.
+    mat4 mvp = u_projection_matrix * u_view_matrix;
 
     for (int i = 0; i < 3; ++i) {
         gl_Position = mvp * vec4(v_position[i], 1.0);
@@ -1,15 +1,13 @@
 #version 300
 precision highp float;
-layout(location = 0) in vec3 a_position; // The vertex position
-layout(location = 1) in vec3 a_norm; // The normal position
-layout(location = 2) in vec2 a_uv; // The uv coord
+#include "common/vertex_attributes.glsl"
 
 out vec3 v_position;
 out vec3 v_norm;
 out vec2 v_uv;
 
 void main() {
-    v_position = a_position;
-    v_norm = a_norm;
+    v_position = vec3(a_model_matrix * vec4(a_position, 1.0));
+    v_norm = vertexNormal();
     v_uv = a_uv;
 }
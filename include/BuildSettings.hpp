@@ -10,4 +10,9 @@ namespace BuildSettings
         debug_without_opengl_callbacks
     };
     static constexpr auto mode = Mode::debug;
+
+    // upload meshes as QuantisedVertex, half the bytes of floats or less, shaders get QUANTISED_VERTICES defined.
+    static constexpr bool quantised_vertices = true;
+    // skip the meshlets of a mesh that are outside the frustum or facing away, drawing the rest as index ranges.
+    static constexpr bool meshlet_culling = true;
 }
\ No newline at end of file
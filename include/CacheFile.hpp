@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <ostream>
+#include <span>
+#include <string_view>
+
+#include "Expected.hpp"
+
+// Helpers shared by the on disk caches, the baked meshes and the program binaries.
+namespace CacheFile {
+	// XXH64 with a zero seed. Fast and non cryptographic, used to key a cached file by what it was made from.
+	auto hashContent(std::span<const char> content) noexcept -> uint64_t;
+
+	// A sibling of path to write to before renaming into place, unique per call so that threads or processes
+	// writing the same file never write into each other's copy.
+	auto temporaryPath(const std::filesystem::path& path) -> std::filesystem::path;
+
+	// Creates the directory of path, lets writeContent fill a temporary file and renames that into place,
+	// so a reader never sees a half written file.
+	auto write(const std::filesystem::path& path, const std::function<void(std::ostream&)>& writeContent) noexcept -> Expected<void, std::string_view>;
+}
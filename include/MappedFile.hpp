@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "Libraries.hpp"
+#include "Expected.hpp"
+
+// Read-only view over a whole file's contents.
+// Native builds map the file copy-on-write (MAP_PRIVATE / FILE_MAP_COPY) so parsing reads straight out of the page cache,
+// web builds have no mmap for the preloaded filesystem, so the file is read into an owned buffer instead.
+class MappedFile {
+private:
+#if BUILD_TARGET == NATIVE_BUILD
+	const char* m_data = nullptr;
+	size_t m_size = 0;
+#if defined(_WIN32)
+	void* m_file_handle = nullptr;
+	void* m_mapping_handle = nullptr;
+#endif
+#elif BUILD_TARGET == WEB_BUILD
+	std::string m_buffer;
+#endif
+
+public:
+	MappedFile() = default;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile();
+
+	auto init(const std::filesystem::path& path) noexcept -> Expected<void, std::string_view>;
+	auto stop() noexcept -> void;
+
+	auto getContent() const noexcept -> std::span<const char>;
+
+	// Hints that the pages fully covered by an already parsed part of the content won't be read again,
+	// so they can be dropped from the resident set rather than held until stop().
+	auto release(std::span<const char> consumed) const noexcept -> void;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "Libraries.hpp"
+
+// Fixed set of worker threads running submitted jobs in order.
+// Web builds aren't compiled with pthreads, so there submit() runs the job straight away and the future is already ready.
+class ThreadPool {
+private:
+	std::vector<std::jthread> m_workers;
+	std::deque<std::function<void()>> m_jobs;
+	std::mutex m_mutex;
+	std::condition_variable m_has_jobs;
+	bool m_is_stopping = false;
+
+public:
+	ThreadPool() = default;
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	~ThreadPool() { stop(); }
+
+	// worker_count of 0 uses every core but one, leaving that for the thread that submits.
+	auto init(size_t worker_count = 0) -> void;
+	// Finishes the jobs already queued, then joins the workers.
+	auto stop() -> void;
+
+	auto getWorkerCount() const noexcept -> size_t { return m_workers.size(); }
+
+	template <typename Job>
+	auto submit(Job&& job) -> std::future<std::invoke_result_t<std::decay_t<Job>>>
+	{
+		using Result = std::invoke_result_t<std::decay_t<Job>>;
+		// std::function needs a copyable callable, the packaged task is only movable.
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Job>(job));
+		std::future<Result> result = task->get_future();
+
+		if (m_workers.empty()) {
+			(*task)();
+			return result;
+		}
+		{
+			std::scoped_lock lock(m_mutex);
+			m_jobs.emplace_back([task]() { (*task)(); });
+		}
+		m_has_jobs.notify_one();
+		return result;
+	}
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "Expected.hpp"
+#include "renderer/3d/Mesh.hpp"
+
+// Versioned binary container for parsed meshes.
+//
+// File layout, all little endian:
+//   FileHeader
+//   MeshRecord[mesh_count]
+//   per mesh, each aligned to data_alignment: vertex_buffer_data floats, index_buffer_data uint32s, lods MeshLods,
+//   meshlets Meshlets
+//
+// The arrays are stored exactly as Mesh<> holds them, so reading a mesh back is a bounds check and a copy per array.
+namespace BakedMesh {
+    // bump whenever the layout of the file or of Mesh<>, or how meshes are processed before baking changes,
+    // older files are then rebaked.
+    constexpr uint32_t version = 5;
+    constexpr std::array<char, 4> magic = { 'W', 'M', 'S', 'H' };
+    constexpr size_t data_alignment = 16;
+    constexpr std::string_view extension = ".wmesh";
+
+    struct FileHeader {
+        std::array<char, 4> magic;
+        uint32_t version;
+        uint64_t source_hash;
+        uint32_t mesh_count;
+        uint32_t reserved;
+    };
+
+    struct MeshRecord {
+        // the MeshType of the mesh, which is also its float count per vertex.
+        uint32_t mesh_type;
+        // floats per attribute in vertex order, e.g. { 3, 3, 2 } for positions, normals, uvs.
+        uint32_t attribute_count;
+        std::array<uint32_t, 4> attribute_sizes;
+        uint64_t num_faces;
+        // byte offsets from the start of the file.
+        uint64_t vertex_offset;
+        uint64_t vertex_float_count;
+        uint64_t index_offset;
+        uint64_t index_count;
+        uint64_t lod_offset;
+        uint64_t lod_count;
+        uint64_t meshlet_offset;
+        uint64_t meshlet_count;
+        std::array<float, 3> bounds_min;
+        std::array<float, 3> bounds_max;
+    };
+
+    auto cachePath(const std::filesystem::path& cache_dir, uint64_t source_hash) -> std::filesystem::path;
+
+    // Fails if the file is missing, from another version, or wasn't baked from content with source_hash.
+    auto read(const std::filesystem::path& path, uint64_t source_hash) noexcept -> Expected<std::vector<MeshVariant>, std::string_view>;
+
+    // Writes to a temporary file first and renames it into place, so a reader never sees a half written file.
+    auto write(const std::filesystem::path& path, uint64_t source_hash, const std::vector<MeshVariant>& meshes) noexcept -> Expected<void, std::string_view>;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "BuildSettings.hpp"
+
+#include "renderer/core/BufferAllocator.hpp"
+#include "renderer/core/IndexBuffer.hpp"
+#include "renderer/core/VertexArray.hpp"
+#include "renderer/core/VertexBuffer.hpp"
+#include "renderer/core/VertexBufferLayout.hpp"
+
+#include "renderer/3d/Mesh.hpp"
+#include "renderer/3d/VertexQuantisation.hpp"
+
+// Every mesh of one vertex format in one position buffer, one attribute buffer and one index buffer,
+// so a pass binds a format's vertex array once rather than once per mesh. Meshes are ranges of the
+// buffers handed out by BufferAllocator, the buffers grow and are repacked when a mesh no longer fits.
+//
+// Native draws offset the indices with glDrawElementsBaseVertex. WebGL2 has no base vertex draws,
+// so there the indices are stored already offset, and a copy of the originals is kept to redo that
+// whenever repacking moves the vertices.
+// Defined for every MeshType in GeometryArena.cpp.
+template <MeshType mesh_type>
+class GeometryArena {
+public:
+    using Handle = uint32_t;
+
+    constexpr static auto getPositionLayout() -> VertexBufferLayout
+    {
+        VertexBufferLayout vbl;
+        if constexpr (BuildSettings::quantised_vertices) {
+            vbl.push<int16_t>(4, true); // positions, see QuantisedPosition
+        } else {
+            vbl.push<float>(3); // positions
+        }
+        return vbl;
+    }
+    constexpr static auto getAttributeLayout() -> VertexBufferLayout
+    {
+        VertexBufferLayout vbl;
+        if constexpr (BuildSettings::quantised_vertices) {
+            if constexpr (hasNormals(mesh_type)) {
+                vbl.push<int16_t>(2, true); // octahedral normals, see QuantisedAttributes
+            }
+            if constexpr (hasUvs(mesh_type)) {
+                vbl.push<HalfFloat>(2); // uvs
+            }
+        } else {
+            if constexpr (hasNormals(mesh_type)) {
+                vbl.push<float>(3); // normals
+            }
+            if constexpr (hasUvs(mesh_type)) {
+                vbl.push<float>(2); // uvs
+            }
+        }
+        return vbl;
+    }
+
+    // where the per instance model matrix starts, after the largest format's attributes. a mat4 takes four locations.
+    constexpr static uint32_t instance_matrix_location = 3;
+    constexpr static auto getInstanceLayout() -> VertexBufferLayout
+    {
+        VertexBufferLayout vbl;
+        for (int column = 0; column < 4; ++column) {
+            vbl.push<float>(4); // a column of the model matrix
+        }
+        return vbl;
+    }
+
+private:
+    // what the buffers start out able to hold, they double from there.
+    constexpr static uint32_t initial_vertex_capacity = 64 * 1024;
+    constexpr static uint32_t initial_index_capacity = 256 * 1024;
+
+    struct Entry {
+        BufferAllocator::Range vertices;
+        BufferAllocator::Range indices;
+        bool is_live;
+#if BUILD_TARGET == WEB_BUILD
+        // relative to the entry's first vertex, see repack.
+        std::vector<uint32_t> original_indices;
+#endif
+    };
+
+    VertexBuffer m_position_vb;
+    // every attribute but the position, left uninitialised for positions_only.
+    VertexBuffer m_attribute_vb;
+    IndexBuffer m_ib;
+    VertexArray m_va;
+    // reads m_position_vb alone, for passes that only write depth.
+    VertexArray m_position_va;
+    BufferAllocator m_vertex_allocator;
+    BufferAllocator m_index_allocator;
+    // indexed by Handle, dead entries are reused by the next add.
+    std::vector<Entry> m_entries;
+    std::vector<Handle> m_free_handles;
+    bool m_is_init = false;
+
+    // Moves every live mesh to the front of new buffers of the given capacities. Also how the buffers grow.
+    auto repack(uint32_t vertex_capacity, uint32_t index_capacity) -> void;
+    auto attachBuffers() -> void;
+
+public:
+    void init();
+    void stop();
+    // binds the vertex array that reads every attribute, with the instances' model matrices read
+    // from offset_in_bytes of instance_vb.
+    void bind(VertexBuffer& instance_vb, size_t offset_in_bytes);
+    // the same for the vertex array that only reads positions. unbind() unbinds either.
+    void bindPositions(VertexBuffer& instance_vb, size_t offset_in_bytes);
+    void unbind();
+
+    // Copies a mesh's streams in, position_bytes and attribute_bytes as the layouts above describe.
+    // Grows or repacks the buffers when there is no room, initialising them on first use.
+    auto add(std::span<const std::byte> position_bytes, std::span<const std::byte> attribute_bytes, std::span<const uint32_t> indices) -> Handle;
+    auto remove(Handle handle) -> void;
+    // squeezes out the holes left by removed meshes.
+    auto compact() -> void;
+
+    // added to every index of the mesh when drawing, always 0 on web where the indices are pre offset.
+    auto getBaseVertex(Handle handle) const noexcept -> int32_t;
+    // where the mesh's indices start in the shared index buffer.
+    auto getFirstIndex(Handle handle) const noexcept -> uint32_t { return m_entries[handle].indices.offset; }
+    auto getIndexType() const noexcept -> uint32_t { return GL_UNSIGNED_INT; }
+    auto getIndexSize() const noexcept -> uint32_t { return sizeof(uint32_t); }
+};
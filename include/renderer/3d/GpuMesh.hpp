@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <variant>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "BuildSettings.hpp"
+
+#include "renderer/3d/GeometryArena.hpp"
+#include "renderer/3d/Mesh.hpp"
+#include "renderer/3d/VertexQuantisation.hpp"
+
+// A mesh uploaded into the GeometryArena of its vertex format, where it is a range of the arena's
+// position, attribute and index buffers. Positions and the other attributes are separate streams,
+// so passes that only need depth bind the position only vertex array and never fetch normals or uvs.
+// Only refers to the arena's buffers, so it can be copied freely, but the arena must outlive it.
+// Defined for every MeshType in GpuMesh.cpp.
+template <MeshType mesh_type>
+class GpuMesh {
+    GeometryArena<mesh_type>* m_arena = nullptr;
+    typename GeometryArena<mesh_type>::Handle m_handle = 0;
+    glm::mat4 m_dequantisation = glm::mat4(1.0f);
+    // ranges of the mesh's indices, from finest to coarsest. always holds at least the full mesh.
+    std::vector<MeshLod> m_lods;
+    std::vector<Meshlet> m_meshlets;
+    // object space, around the mesh's bounds.
+    glm::vec3 m_bounding_centre = { 0, 0, 0 };
+    float m_bounding_radius = 0.0f;
+
+public:
+    void init(const Mesh<mesh_type>& mesh, GeometryArena<mesh_type>& arena);
+    // gives the mesh's ranges back to the arena.
+    void stop();
+    // binds the arena's vertex array, which every mesh of the format shares, see GeometryArena::bind.
+    void bind(VertexBuffer& instance_vb, size_t offset_in_bytes);
+    // binds the arena's vertex array that only reads positions, for depth only passes. unbind() unbinds either.
+    void bindPositions(VertexBuffer& instance_vb, size_t offset_in_bytes);
+    void unbind();
+
+    // shared by every mesh of the format.
+    auto getArena() const noexcept -> GeometryArena<mesh_type>& { return *m_arena; }
+    auto getIndexType() const noexcept -> uint32_t { return m_arena->getIndexType(); }
+    auto getIndexSize() const noexcept -> uint32_t { return m_arena->getIndexSize(); }
+    // where the mesh's indices start in the arena's index buffer, MeshLod and Meshlet offsets are relative to it.
+    auto getFirstIndex() const noexcept -> uint32_t { return m_arena->getFirstIndex(m_handle); }
+    // for glDrawElementsBaseVertex, see GeometryArena::getBaseVertex.
+    auto getBaseVertex() const noexcept -> int32_t { return m_arena->getBaseVertex(m_handle); }
+
+    auto getLodCount() const noexcept -> uint32_t { return static_cast<uint32_t>(m_lods.size()); }
+    // lod is clamped to the coarsest level.
+    auto getLod(uint32_t lod) const noexcept -> MeshLod { return m_lods[std::min<size_t>(lod, m_lods.size() - 1)]; }
+    // the meshlets of one level, see getLod.
+    auto getMeshlets(const MeshLod& lod) const noexcept -> std::span<const Meshlet> { return std::span{ m_meshlets }.subspan(lod.meshlet_offset, lod.meshlet_count); }
+    auto getBoundingCentre() const noexcept -> const glm::vec3& { return m_bounding_centre; }
+    auto getBoundingRadius() const noexcept -> float { return m_bounding_radius; }
+    // goes on the right of the model matrix, maps the stored positions back into object space.
+    auto getDequantisationMatrix() const noexcept -> const glm::mat4& { return m_dequantisation; }
+};
+
+// Holds whichever GpuMesh a MeshVariant uploads to, draw it with std::visit rather than checking the type.
+using GpuMeshVariant = std::variant<GpuMesh<MeshType::positions_only>, GpuMesh<MeshType::positions_and_normals>, GpuMesh<MeshType::positions_normals_uvs>>;
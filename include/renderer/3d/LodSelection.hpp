@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include <glm/glm.hpp>
+
+#include "renderer/3d/GpuMesh.hpp"
+
+// Picks a level of detail for a model part from how much of the screen it covers, so dense meshes
+// cost roughly in proportion to their footprint rather than to how they were authored.
+namespace LodSelection {
+    // the most triangles worth drawing per covered pixel, past this the extra detail is sub pixel.
+    constexpr float triangles_per_pixel = 0.25f;
+
+    // Area in pixels of the projected bounding sphere. Spheres reaching the near plane count as covering everything.
+    auto projectedArea(const glm::vec3& centre, float radius, const glm::mat4& model_view, const glm::mat4& projection, float viewport_height) noexcept -> float;
+
+    // The finest level whose triangles, summed over every mesh of the part, fit the part's footprint.
+    // Meshes with fewer levels use their coarsest one for the levels they lack.
+    auto selectLod(std::span<const GpuMeshVariant> meshes, const glm::mat4& model_view, const glm::mat4& projection, float viewport_height) noexcept -> uint32_t;
+}
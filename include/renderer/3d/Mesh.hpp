@@ -1,10 +1,14 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 #include <string_view>
 #include <variant>
 #include <vector>
+#include <glm/glm.hpp>
 #include "Expected.hpp"
+#include "renderer/3d/MeshOptimiser.hpp"
+#include "renderer/3d/Meshlets.hpp"
 
 enum class MeshType {
     positions_only = 3,
@@ -12,28 +16,40 @@ enum class MeshType {
     positions_normals_uvs = 8
 };
 
-template <MeshType Type>
-struct Mesh {
+// A contiguous range of a mesh's index_buffer_data holding one level of detail,
+// and the range of the mesh's meshlets that split it up.
+struct MeshLod {
+    uint32_t index_offset;
+    uint32_t index_count;
+    uint32_t meshlet_offset;
+    uint32_t meshlet_count;
 };
 
-template <>
-struct Mesh<MeshType::positions_only> {
-    constexpr static size_t floats_per_vertex_attribute = 3;
-    size_t num_faces;
-    std::vector<float> vertex_buffer_data;
-};
-template <>
-struct Mesh<MeshType::positions_and_normals> {
-    constexpr static size_t floats_per_vertex_attribute = 3 + 3;
-    size_t num_faces;
-    std::vector<float> vertex_buffer_data;
-};
-template <>
-struct Mesh<MeshType::positions_normals_uvs> {
-    constexpr static size_t floats_per_vertex_attribute = 3 + 3 + 2;
+constexpr auto hasNormals(MeshType type) -> bool
+{
+    return type != MeshType::positions_only;
+}
+constexpr auto hasUvs(MeshType type) -> bool
+{
+    return type == MeshType::positions_normals_uvs;
+}
+
+// An indexed mesh whose vertices are the floats of each attribute of Type in turn, e.g. x y z nx ny nz u v.
+template <MeshType Type>
+struct Mesh {
+    constexpr static size_t floats_per_vertex_attribute = static_cast<size_t>(Type);
     size_t num_faces;
+    // deduplicated vertices, each one referenced by index_buffer_data.
     std::vector<float> vertex_buffer_data;
-    void* texture;
+    std::vector<uint32_t> index_buffer_data;
+    // levels of detail from finest to coarsest, all indexing the same vertices. lods[0] is the full mesh,
+    // the coarser levels' indices follow it in index_buffer_data. empty until the loader has processed the mesh.
+    std::vector<MeshLod> lods;
+    // every level's meshlets, with offsets into index_buffer_data.
+    std::vector<Meshlet> meshlets;
+    // object space axis aligned box around every position.
+    glm::vec3 bounds_min;
+    glm::vec3 bounds_max;
 };
 
 using MeshVariant = std::variant<
@@ -42,5 +58,31 @@ using MeshVariant = std::variant<
     Mesh<MeshType::positions_normals_uvs>>;
 
 namespace MeshLoader {
-    auto fromObj(std::filesystem::path obj_path) noexcept -> Expected<std::vector<MeshVariant>, std::string_view>;
+    // where parsed obj files are baked to, keyed by a hash of the obj's contents.
+    inline const std::filesystem::path cache_directory = "assets/cache/meshes";
+
+    // Loads the baked copy of the obj from cache_directory when there is one, otherwise parses the obj
+    // and (on native builds) bakes it for next time. Large objs are parsed on up to max_threads threads,
+    // 0 uses one per core. Callers already running on a pool should pass 1.
+    auto fromObj(std::filesystem::path obj_path, size_t max_threads = 0) noexcept -> Expected<std::vector<MeshVariant>, std::string_view>;
+
+    // Parses the obj as written, without the baked cache or any optimisation. The meshes are the same
+    // whatever max_threads is.
+    auto parseObj(const std::filesystem::path& obj_path, size_t max_threads = 0) noexcept -> Expected<std::vector<MeshVariant>, std::string_view>;
+
+    struct MeshReport {
+        // how the optimiser changed the full level.
+        MeshOptimiser::Report optimisation;
+        // the triangle count of every level, finest first.
+        std::vector<size_t> lod_triangle_counts;
+    };
+
+    struct BakedObj {
+        std::filesystem::path baked_path;
+        // one per indexed mesh, in the order of the meshes.
+        std::vector<MeshReport> reports;
+    };
+
+    // Parses, optimises and builds the levels of detail of the obj, then writes its baked copy into the cache directory.
+    auto bakeObj(std::filesystem::path obj_path, std::filesystem::path cache_dir = cache_directory) noexcept -> Expected<BakedObj, std::string_view>;
 }
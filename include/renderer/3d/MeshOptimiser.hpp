@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// Reorders indexed triangle lists so the gpu does less work drawing them, without changing what is drawn.
+// Run in this order: vertex cache, then overdraw (which keeps most of the cache gains), then vertex fetch.
+namespace MeshOptimiser {
+    // the fifo size the statistics are simulated with, roughly what post transform caches behave like.
+    constexpr size_t analysis_cache_size = 16;
+
+    struct VertexCacheStatistics {
+        size_t triangle_count = 0;
+        size_t vertices_transformed = 0;
+        // average cache miss ratio, vertices transformed per triangle. 0.5 is ideal, 3 is no reuse at all.
+        float acmr = 0.0f;
+        // average transform to vertex ratio, vertices transformed per unique vertex. 1 is ideal.
+        float atvr = 0.0f;
+    };
+
+    struct Report {
+        VertexCacheStatistics before;
+        VertexCacheStatistics after;
+    };
+
+    auto analyseVertexCache(std::span<const uint32_t> indices, size_t vertex_count, size_t cache_size = analysis_cache_size) -> VertexCacheStatistics;
+
+    // Forsyth's linear speed vertex cache optimisation, reorders the triangles in place.
+    void optimiseVertexCache(std::span<uint32_t> indices, size_t vertex_count);
+
+    // Splits cache optimised triangles into clusters at the points that cost the least cache efficiency,
+    // then draws the clusters facing outwards from the mesh's centre first so they occlude the rest.
+    // threshold is how much worse than the cache optimised acmr the result may be, e.g. 1.05 is 5%.
+    void optimiseOverdraw(std::span<uint32_t> indices, std::span<const float> vertex_data, size_t floats_per_vertex, float threshold = 1.05f);
+
+    // Renumbers the vertices in the order the indices first use them, so vertex fetches walk the buffer forwards.
+    void optimiseVertexFetch(std::span<uint32_t> indices, std::span<float> vertex_data, size_t floats_per_vertex);
+}
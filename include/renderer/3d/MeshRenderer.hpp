@@ -1,55 +1,47 @@
 #pragma once
 
 #include <concepts>
+#include <span>
 #include <type_traits>
+#include <vector>
 
 #include <glm/glm.hpp>
 
 #include "Concept.hpp"
 
-#include "renderer/core/IndexBuffer.hpp"
+#include "renderer/core/MultiDraw.hpp"
 #include "renderer/core/Shader.hpp"
 #include "renderer/core/Texture.hpp"
-#include "renderer/core/VertexArray.hpp"
-#include "renderer/core/VertexBuffer.hpp"
-#include "renderer/core/VertexBufferLayout.hpp"
 
+#include "renderer/3d/GpuMesh.hpp"
 #include "renderer/3d/Mesh.hpp"
 #include "renderer/3d/Light.hpp"
 
-struct SharedIndexBuffer {
-    static IndexBuffer ib;
-    static std::vector<uint32_t> index_buffer_data;
-    static bool hasCapacityFor(size_t num_faces);
-    static void makeCapacityFor(size_t num_faces);
-};
-
+// Draws GpuMesh<mesh_type>, defined for every MeshType in MeshRenderer.cpp so each layout gets its own draw code.
+// Pick the renderer for a GpuMeshVariant with std::visit.
+// Draws are queued with addDraw and submitted together, every mesh of a layout shares its GeometryArena,
+// so a whole batch goes out through MultiDraw in one call where the context allows it. Every draw is
+// instanced, one instance per model matrix, which the shaders read as a_model_matrix.
 template <MeshType mesh_type>
 class MeshRenderer {
-};
-
-template <>
-class MeshRenderer<MeshType::positions_normals_uvs> {
-    constexpr static auto getLayout() -> VertexBufferLayout
-    {
-        VertexBufferLayout vbl;
-        vbl.push<float>(3); // positions
-        vbl.push<float>(3); // normals
-        vbl.push<float>(2); // uvs
-
-        return vbl;
-    }
+    // the queued draws' model matrices with their mesh's dequantisation applied, each command's
+    // base_instance indexes its own. both are reused between batches.
+    std::vector<glm::mat4> m_instance_matrices;
+    std::vector<DrawElementsIndirectCommand> m_commands;
+    // of the queued meshes.
+    GeometryArena<mesh_type>* m_arena = nullptr;
 
-    VertexBuffer m_vb;
-    VertexArray m_va;
-
-    void bindAll();
-    void unbindAll();
+    // streams the instances through FrameStream::vertices() and draws every queued command.
+    void submitCommands(bool positions_only);
 
 public:
     void init();
     void stop();
-    
-    void draw(const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection, const Mesh<MeshType::positions_normals_uvs>& mesh, Shader& shader);
-    void draw(const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection, const Mesh<MeshType::positions_normals_uvs>& mesh, Shader& shader, const std::vector<PointLight>& lights);
+
+    // Queues the mesh's draw, once per model matrix. lod is clamped to the mesh's coarsest level, see LodSelection.
+    void addDraw(std::span<const glm::mat4> models, const glm::mat4& view, const glm::mat4& projection, GpuMesh<mesh_type>& mesh, uint32_t lod = 0);
+    // Draws the queued draws with the bound shader. The bound Camera block should hold the view and projection they were added with.
+    void submit();
+    // reads positions alone, for passes that only write depth.
+    void submitDepth();
 };
\ No newline at end of file
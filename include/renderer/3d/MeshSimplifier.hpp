@@ -0,0 +1,24 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Builds coarser versions of an indexed triangle list with quadric error metric edge collapses.
+// Vertices only ever collapse onto neighbouring vertices, so every level indexes the original vertex data,
+// and vertices on borders or attribute seams (several vertices sharing a position) never move.
+namespace MeshSimplifier {
+    // the fraction of the full mesh's triangles each level aims for.
+    constexpr std::array<float, 3> lod_ratios = { 0.5f, 0.25f, 0.125f };
+    // the largest distance a surface may move, relative to the mesh's largest dimension, before the chain stops.
+    constexpr float max_relative_error = 0.02f;
+    // below this there's too little to gain from a coarser level.
+    constexpr size_t min_triangle_count = 256;
+
+    // Returns one index list per ratio the mesh could be simplified to within max_error, finest first.
+    // The first three floats of each vertex are its position, the rest are attributes that collapses try to preserve.
+    auto buildLodChain(std::span<const uint32_t> indices, std::span<const float> vertex_data, size_t floats_per_vertex,
+        std::span<const float> ratios = lod_ratios, float max_error = max_relative_error) -> std::vector<std::vector<uint32_t>>;
+}
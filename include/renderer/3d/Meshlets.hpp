@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// A run of consecutive triangles small enough to be culled as one, see Meshlets::isVisible.
+struct Meshlet {
+    uint32_t index_offset;
+    uint32_t index_count;
+    // object space sphere around the meshlet's vertices.
+    glm::vec3 centre;
+    float radius;
+    // the meshlet faces away from any viewer in the cone behind its sphere, opening around -cone_axis.
+    // cone_cutoff is the sine of the cone's half angle, 1 when the meshlet can face every way and is never rejected.
+    glm::vec3 cone_axis;
+    float cone_cutoff;
+};
+
+namespace Meshlets {
+    constexpr size_t max_vertices = 64;
+    constexpr size_t max_triangles = 124;
+    // triangles bending further than this from the meshlet's average normal are left for another meshlet, so the
+    // cones stay narrow enough to reject. the cosine of about 75 degrees.
+    constexpr float max_normal_deviation = 0.25f;
+    // how many new vertices facing the meshlet's way is worth when growing it.
+    constexpr float normal_weight = 2.0f;
+
+    // Grows meshlets across neighbouring triangles, reordering the triangles in place so each meshlet is a contiguous range.
+    // Meshlets are seeded in the triangles' existing order, so the order the optimiser picked mostly survives.
+    // The first three floats of each vertex are its position. Offsets are relative to the start of indices.
+    auto build(std::span<uint32_t> indices, std::span<const float> vertex_data, size_t floats_per_vertex) -> std::vector<Meshlet>;
+
+    // The frustum and viewer, moved into the space of the meshlets.
+    struct CullingView {
+        // left, right, bottom, top, near, far, normalised so distances are in object space units.
+        std::array<glm::vec4, 6> planes;
+        glm::vec3 camera_position;
+    };
+
+    // model_view must only scale uniformly, as Model::Transforms does.
+    auto cullingViewOf(const glm::mat4& model_view, const glm::mat4& projection) noexcept -> CullingView;
+
+    // False when the meshlet is outside the frustum or every triangle in it faces away from the camera.
+    auto isVisible(const Meshlet& meshlet, const CullingView& view) noexcept -> bool;
+}
@@ -1,17 +1,23 @@
 #pragma once
 
 #include "renderer/3d/Camera.hpp"
+#include "renderer/3d/GpuMesh.hpp"
 #include "renderer/3d/Light.hpp"
 #include "renderer/3d/Mesh.hpp"
 #include "renderer/3d/MeshRenderer.hpp"
 
 #include "Components.hpp"
 #include "Ecs.hpp"
+#include "ThreadPool.hpp"
 #include "renderer/core/Input.hpp"
+#include "renderer/core/ProgramCache.hpp"
 #include "renderer/core/Shader.hpp"
 
 #include <glaze/glaze.hpp>
 #include <glm/glm.hpp>
+#include <chrono>
+#include <future>
+#include <tuple>
 #include <unordered_map>
 #include <vector>
 
@@ -66,13 +72,46 @@ public: // members
 
 private:
 	std::unordered_map<SceneTypes::MeshKey, std::vector<MeshVariant>> m_mesh_lookup;
+	std::unordered_map<SceneTypes::MeshKey, std::vector<GpuMeshVariant>> m_gpu_mesh_lookup;
+	// where the gpu meshes of each MeshType live, in MeshVariant order.
+	std::tuple<
+		GeometryArena<MeshType::positions_only>,
+		GeometryArena<MeshType::positions_and_normals>,
+		GeometryArena<MeshType::positions_normals_uvs>> m_geometry_arenas;
 	std::unordered_map<SceneTypes::ShaderKey, Shader, ShaderKeyHash> m_shader_lookup;
 	std::unordered_map<SceneTypes::TextureKey, Texture> m_texture_lookup;
 
+	// resources being read and decoded on the loading pool, or waiting for their turn on the gl thread.
+	// until they are uploaded the renderer skips parts without their mesh or shader and uses a placeholder texture.
+	struct PendingMeshes {
+		SceneTypes::MeshKey mesh_key;
+		std::future<Expected<std::vector<MeshVariant>, std::string_view>> meshes;
+	};
+	struct PendingImage {
+		SceneTypes::TextureKey texture_key;
+		std::future<Expected<Texture::Image, std::string_view>> image;
+	};
+	std::vector<PendingMeshes> m_pending_meshes;
+	std::vector<PendingImage> m_pending_images;
+	std::vector<SceneTypes::ShaderKey> m_pending_shaders;
+
+	// how long a frame may spend creating gpu resources from loaded ones, at least one is always created.
+	constexpr static auto upload_budget = std::chrono::microseconds(4000);
+
 private: // methods
+	// Starts reading every resource the models use on the loading pool, update() then uploads them as they finish.
 	[[nodiscard]] auto loadResources() -> Expected<void, std::string_view>;
+	auto uploadLoadedResources() -> void;
+	auto uploadMeshes(const SceneTypes::MeshKey& mesh_key) -> void;
 	auto offloadResources() -> void;
 
+	static auto loadingPool() -> ThreadPool&
+	{
+		static ThreadPool pool;
+		[[maybe_unused]] static bool is_init = (pool.init(), true);
+		return pool;
+	}
+
 public:
 	Scene() = default;
 
@@ -105,8 +144,12 @@ public:
 		infile.read(&content[0], fileSize);
 
 		if (auto has_result = glz::read_json<Scene>(content); has_result) {
-			has_result.value().camera = camera;
-			*this = has_result.value();
+			// only take what the file describes, assigning the whole scene would drop the geometry arenas' buffers.
+			Scene& loaded = has_result.value();
+			background_colour = loaded.background_colour;
+			models = std::move(loaded.models);
+			point_lights = std::move(loaded.point_lights);
+			entities = std::move(loaded.entities);
 		}
 		else {
 			std::cerr << glz::format_error(has_result.error(), content) << '\n';
@@ -124,100 +167,184 @@ public:
 
 	auto update(float dt, const Input& input)
 	{
+		uploadLoadedResources();
 		camera.update(dt, input);
 	}
 
+	// resources still being loaded, the scene draws with placeholders until this reaches 0.
+	auto getPendingResourceCount() const noexcept -> size_t
+	{
+		return m_pending_meshes.size() + m_pending_images.size() + m_pending_shaders.size();
+	}
+
 	friend class Renderer;
-	friend class MeshRenderer<MeshType::positions_normals_uvs>;
+	template <MeshType> friend class MeshRenderer;
 	friend struct Model;
 	friend struct glz::meta<Scene>;
 };
 
 inline auto Scene::loadResources() -> Expected<void, std::string_view>
 {
-	for (Model& model : models) {
+	auto requestResources = [&](const Model& model) {
 		for (const auto& [mesh_key, shader_key, transforms, needs_point_lights, maybe_texture_key] : model.model_parts) {
+			const bool is_mesh_requested = m_mesh_lookup.contains(mesh_key)
+				|| std::ranges::any_of(m_pending_meshes, [&](const PendingMeshes& pending) { return pending.mesh_key == mesh_key; });
+			if (!is_mesh_requested) {
+				m_pending_meshes.emplace_back(PendingMeshes{
+					.mesh_key = mesh_key,
+					// the pool already keeps every core busy with one file each, more threads per file would only contend.
+					.meshes = loadingPool().submit([mesh_key]() { return MeshLoader::fromObj(mesh_key, 1); }) });
+			}
+
+			const bool is_shader_requested = m_shader_lookup.contains(shader_key)
+				|| std::ranges::find(m_pending_shaders, shader_key) != m_pending_shaders.end();
+			if (!is_shader_requested) {
+				m_pending_shaders.emplace_back(shader_key);
+			}
 
-			auto addLoadedMeshes = [&](auto&& meshes) -> Expected<std::vector<MeshVariant>, std::string_view> {
-				m_mesh_lookup[mesh_key] = meshes;
-				return {};
-				};
+			if (!maybe_texture_key) {
+				continue;
+			}
+			const auto& texture_key = maybe_texture_key.value();
+			const bool is_texture_requested = m_texture_lookup.contains(texture_key)
+				|| std::ranges::any_of(m_pending_images, [&](const PendingImage& pending) { return pending.texture_key == texture_key; });
+			if (!is_texture_requested) {
+				if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+					if (std::filesystem::path{ texture_key }.extension() != ".png") {
+						std::cerr
+							<< "Bad asset. Texture \""
+							<< texture_key
+							<< "\" needs the file extension .png";
+						exit(EXIT_FAILURE);
+					}
+				}
+				m_pending_images.emplace_back(PendingImage{
+					.texture_key = texture_key,
+					.image = loadingPool().submit([texture_key]() { return Texture::loadImage(texture_key); }) });
+			}
+		}
+	};
+
+	for (const Model& model : models) {
+		requestResources(model);
+	}
+	for (auto [model] : entities.forAnyWith<Model>()) {
+		requestResources(model);
+	}
+	return {};
+}
+inline auto Scene::uploadLoadedResources() -> void
+{
+	using Clock = std::chrono::steady_clock;
+	const auto deadline = Clock::now() + upload_budget;
+	bool has_uploaded = false;
+	auto hasBudget = [&]() {
+		return !has_uploaded || Clock::now() < deadline;
+	};
+	auto isReady = [](const auto& future) {
+		return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	};
 
-			auto printError = [&](std::string_view error) -> Expected<std::vector<MeshVariant>, std::string_view> {
+	for (auto pending = m_pending_meshes.begin(); pending != m_pending_meshes.end() && hasBudget();) {
+		if (!isReady(pending->meshes)) {
+			++pending;
+			continue;
+		}
+		auto meshes = pending->meshes.get();
+		meshes
+			.OnValue([&](std::vector<MeshVariant>& loaded_meshes) {
+				m_mesh_lookup[pending->mesh_key] = std::move(loaded_meshes);
+				uploadMeshes(pending->mesh_key);
+			})
+			.OnError([&](std::string_view error) {
 				if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
 					std::cerr
 						<< "Unable to load mesh: \""
-						<< mesh_key
+						<< pending->mesh_key
 						<< "\".Where the error was:"
 						<< error
 						<< std::endl;
 					exit(EXIT_FAILURE);
 				}
-				return { error };
-				};
-
-			if (!m_mesh_lookup.contains(mesh_key)) {
-				MeshLoader::fromObj(mesh_key)
-					.OnValue(addLoadedMeshes)
-					.OnError(printError);
-			}
-
-			if (!m_shader_lookup.contains(shader_key)) {
-				auto [vert, frag, maybe_geo] = shader_key;
-				auto& shader = (m_shader_lookup[shader_key] = Shader());
-				shader.init(vert, frag, maybe_geo);
-				shader.uploadToGpu();
-			}
-
-			if (maybe_texture_key && !m_texture_lookup.contains(maybe_texture_key.value())) {
-				Texture& texture = (m_texture_lookup[maybe_texture_key.value()] = Texture{});
-				texture.init(maybe_texture_key.value());
-				texture.uploadToGpu();
-			}
-		}
+			});
+		pending = m_pending_meshes.erase(pending);
+		has_uploaded = true;
 	}
 
-	Model model;
-	model.model_parts.emplace_back(Model::ModelPart{
-		.mesh_key = "assets/objects/trail.obj",
-		.shader_key = {},
-		.transforms = {.translation = { 0, 0, 0 }, .scale = 1.0f },
-		.needs_point_lights = false,
-		.texture_key = std::nullopt
-		});
-
-	for (auto [model] : entities.forAnyWith<Model>()) {
-		for (const auto& [mesh_key, shader_key, transforms, needs_point_lights, maybe_texture_key] : model.model_parts) {
-
-			auto addLoadedMeshes = [&](auto&& meshes) -> Expected<std::vector<MeshVariant>, std::string_view> {
-				m_mesh_lookup[mesh_key] = meshes;
-				return {};
-				};
-
-			auto printError = [&](std::string_view error) -> Expected<std::vector<MeshVariant>, std::string_view> {
+	for (auto pending = m_pending_images.begin(); pending != m_pending_images.end() && hasBudget();) {
+		if (!isReady(pending->image)) {
+			++pending;
+			continue;
+		}
+		auto image = pending->image.get();
+		image
+			.OnValue([&](Texture::Image& loaded_image) {
+				Texture& texture = (m_texture_lookup[pending->texture_key] = Texture{});
+				texture.init(pending->texture_key, std::move(loaded_image));
+				texture.uploadToGpu();
+			})
+			.OnError([&](std::string_view error) {
 				if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
 					std::cerr
-						<< "Unable to load mesh: \""
-						<< mesh_key
+						<< "Unable to load texture: \""
+						<< pending->texture_key
 						<< "\".Where the error was:"
 						<< error
 						<< std::endl;
 					exit(EXIT_FAILURE);
 				}
-				return { error };
-				};
+			});
+		pending = m_pending_images.erase(pending);
+		has_uploaded = true;
+	}
 
-			if (!m_mesh_lookup.contains(mesh_key)) {
-				MeshLoader::fromObj(mesh_key)
-					.OnValue(addLoadedMeshes)
-					.OnError(printError);
-			}
-		}
+	bool has_uploaded_shader = false;
+	while (!m_pending_shaders.empty() && hasBudget()) {
+		const SceneTypes::ShaderKey shader_key = std::move(m_pending_shaders.back());
+		m_pending_shaders.pop_back();
+		auto [vert, frag, maybe_geo] = shader_key;
+		auto& shader = (m_shader_lookup[shader_key] = Shader());
+		shader.init(vert, frag, maybe_geo);
+		shader.uploadToGpu();
+		has_uploaded = true;
+		has_uploaded_shader = true;
+	}
+	// reported once the scene's last shader is up, to measure what the program cache saves.
+	if (has_uploaded_shader && m_pending_shaders.empty()) {
+		const ProgramCache::Stats& stats = ProgramCache::getStats();
+		std::cout
+			<< "Shaders: " << stats.loaded << " loaded from binaries in " << stats.loading_time.count() << "ms, "
+			<< stats.compiled << " compiled in " << stats.compiling_time.count() << "ms ("
+			<< stats.misses << " cache misses, " << stats.rejections << " binaries rejected).\n";
+		ProgramCache::resetStats();
+	}
+}
+inline auto Scene::uploadMeshes(const SceneTypes::MeshKey& mesh_key) -> void
+{
+	const auto& meshes = m_mesh_lookup[mesh_key];
+	auto& gpu_meshes = m_gpu_mesh_lookup[mesh_key];
+
+	for (auto& gpu_mesh : gpu_meshes) {
+		std::visit([](auto& typed_gpu_mesh) { typed_gpu_mesh.stop(); }, gpu_mesh);
+	}
+	gpu_meshes.clear();
+	gpu_meshes.reserve(meshes.size());
+	for (const auto& mesh : meshes) {
+		std::visit([&]<MeshType type>(const Mesh<type>& typed_mesh) {
+			auto& gpu_mesh = std::get<GpuMesh<type>>(gpu_meshes.emplace_back(std::in_place_type<GpuMesh<type>>));
+			gpu_mesh.init(typed_mesh, std::get<GeometryArena<type>>(m_geometry_arenas));
+		}, mesh);
 	}
-	return {};
 }
 inline auto Scene::offloadResources() -> void
 {
+	// anything still loading finishes on the pool and is dropped with its future.
+	m_pending_meshes.clear();
+	m_pending_images.clear();
+	m_pending_shaders.clear();
+	// the arenas take every gpu mesh's buffers with them.
+	m_gpu_mesh_lookup.clear();
+	std::apply([](auto&... arenas) { (arenas.stop(), ...); }, m_geometry_arenas);
 	m_mesh_lookup.clear();
 	m_shader_lookup.clear();
 	m_texture_lookup.clear();
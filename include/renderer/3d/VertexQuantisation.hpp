@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "renderer/3d/Mesh.hpp"
+#include "renderer/core/VertexBufferLayout.hpp"
+
+// snorm16 position within the mesh's bounds, see QuantisedMesh::dequantisation. w is padding.
+using QuantisedPosition = std::array<int16_t, 4>;
+static_assert(sizeof(QuantisedPosition) == 8);
+
+// The rest of a Mesh<Type> vertex, kept in its own stream so passes that only need positions never fetch it.
+// positions_only meshes have none.
+template <MeshType Type>
+struct QuantisedAttributes {
+};
+
+template <>
+struct QuantisedAttributes<MeshType::positions_and_normals> {
+    // snorm16 octahedral encoded unit normal.
+    std::array<int16_t, 2> normal;
+};
+
+template <>
+struct QuantisedAttributes<MeshType::positions_normals_uvs> {
+    std::array<int16_t, 2> normal;
+    std::array<HalfFloat, 2> uv;
+};
+static_assert(sizeof(QuantisedAttributes<MeshType::positions_and_normals>) == 4);
+static_assert(sizeof(QuantisedAttributes<MeshType::positions_normals_uvs>) == 8);
+
+// A Mesh<Type>'s vertices in half the bytes of floats or less, split into a position and an attribute stream.
+template <MeshType Type>
+struct QuantisedMesh {
+    std::vector<QuantisedPosition> positions;
+    // empty for positions_only.
+    std::vector<QuantisedAttributes<Type>> attributes;
+    // maps the snorm positions back into object space. the scale is the same on every axis,
+    // so folding it into the model matrix doesn't skew the normals.
+    glm::mat4 dequantisation;
+};
+
+namespace VertexQuantisation {
+    // round to nearest even, out of range values become infinity.
+    auto toHalf(float value) noexcept -> HalfFloat;
+    auto fromHalf(HalfFloat value) noexcept -> float;
+
+    // value is clamped into [-1, 1].
+    auto toSnorm16(float value) noexcept -> int16_t;
+    auto fromSnorm16(int16_t value) noexcept -> float;
+
+    // Maps a unit vector onto the [-1, 1] square, see "A Survey of Efficient Representations for Independent Unit Vectors".
+    auto encodeOctahedral(glm::vec3 normal) noexcept -> glm::vec2;
+    auto decodeOctahedral(glm::vec2 encoded) noexcept -> glm::vec3;
+
+    template <MeshType Type>
+    auto quantise(const Mesh<Type>& mesh) -> QuantisedMesh<Type>;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Orders a pass's items by a packed 64 bit key, so one sort groups them by everything that costs a state change.
+// Opaque keys go pass, shader, texture, mesh, depth, so items sharing state end up next to each other and are
+// drawn front to back within it. Transparent keys put the depth, inverted, straight after the pass, so they are
+// drawn back to front after every opaque item whatever their state.
+class RenderQueue {
+public:
+	enum class Pass : uint64_t {
+		opaque = 0,
+		transparent = 1,
+	};
+	struct Entry {
+		uint64_t key;
+		// into the caller's items.
+		uint32_t item;
+	};
+
+	constexpr static uint32_t pass_bits = 2;
+	constexpr static uint32_t shader_bits = 10;
+	constexpr static uint32_t texture_bits = 10;
+	// the mesh's id and its level of detail.
+	constexpr static uint32_t mesh_bits = 16;
+	constexpr static uint32_t depth_bits = 24;
+	static_assert(pass_bits + shader_bits + texture_bits + mesh_bits + depth_bits <= 64);
+
+private:
+	std::vector<Entry> m_entries;
+	std::vector<Entry> m_scratch;
+
+public:
+	// Non negative depths compare the same as their float bits, so the top depth_bits of them keep the order.
+	static auto quantiseDepth(float view_depth) noexcept -> uint32_t;
+	// ids past what their bits hold share the largest id, that only costs sort quality.
+	static auto makeKey(Pass pass, uint32_t shader, uint32_t texture, uint32_t mesh, uint32_t depth) noexcept -> uint64_t;
+
+	auto clear() noexcept -> void { m_entries.clear(); }
+	auto push(uint64_t key, uint32_t item) -> void { m_entries.push_back({ key, item }); }
+	// Stable, least significant byte first radix sort, skipping the bytes every key shares.
+	auto sort() -> void;
+	auto getEntries() const noexcept -> std::span<const Entry> { return m_entries; }
+};
@@ -1,99 +1,286 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <ranges>
 #include <tuple>
+#include <unordered_map>
+#include <variant>
+#include <vector>
 
+#include "3d/LodSelection.hpp"
 #include "3d/MeshRenderer.hpp"
 #include "3d/Scene.hpp"
 #include "core/OpenglContext.hpp"
 #include "3d/Camera.hpp"
+#include "core/GlState.hpp"
+#include "core/StreamBuffer.hpp"
+#include "RenderQueue.hpp"
 
 class Renderer {
-	MeshRenderer<MeshType::positions_normals_uvs> m_pnu_renderer;
-public:
-	void init()
+	// one per MeshType, in MeshVariant order.
+	std::tuple<
+		MeshRenderer<MeshType::positions_only>,
+		MeshRenderer<MeshType::positions_and_normals>,
+		MeshRenderer<MeshType::positions_normals_uvs>> m_mesh_renderers;
+	// drawn in place of textures that are still loading.
+	Texture m_placeholder_texture;
+	// transforms positions and writes nothing but depth, for the depth and shadow passes.
+	Shader m_depth_shader;
+
+	auto getTextureOrPlaceholder(Scene& scene, const SceneTypes::TextureKey& texture_key) -> Texture&
 	{
-		m_pnu_renderer.init();
+		auto texture_it = scene.m_texture_lookup.find(texture_key);
+		return (texture_it != scene.m_texture_lookup.end()) ? texture_it->second : m_placeholder_texture;
+	}
+
+	// A model part flattened out of the scene's models or entities, see extract.
+	struct RenderItem {
+		std::vector<GpuMeshVariant>* meshes;
+		// nullptr while the shader is still loading, the item only shows up in depth passes until then.
+		Shader* shader;
+		// only for unlit parts, lit parts aren't textured.
+		Texture* texture;
+		bool has_point_lighting;
+		bool is_transparent;
+		// only the scene's models cast shadows.
+		bool is_entity;
+		glm::mat4 model_matrix;
+	};
+	std::vector<RenderItem> m_render_items;
+
+	// Items sharing meshes, level of detail, shader and texture, drawn together as instances.
+	struct InstanceGroup {
+		std::vector<GpuMeshVariant>* meshes;
+		uint32_t lod;
+		Shader* shader;
+		Texture* texture;
+		bool has_point_lighting;
+		bool is_transparent;
+		std::vector<glm::mat4> model_matrices;
+	};
+	// kept between frames so the groups' matrices reuse their allocations.
+	std::vector<InstanceGroup> m_instance_groups;
+	RenderQueue m_render_queue;
+	// each item's level of detail for the pass's camera.
+	std::vector<uint32_t> m_lods;
+	// the pass's dense ids for the queue's keys, in order of first use.
+	std::unordered_map<const void*, uint32_t> m_shader_ids;
+	std::unordered_map<const void*, uint32_t> m_texture_ids;
+	std::unordered_map<const void*, uint32_t> m_mesh_ids;
 
+	static auto getModelMatrix(const Model::Transforms& transforms) -> glm::mat4
+	{
+		return glm::scale(glm::translate(glm::mat4(1.0f), transforms.translation), glm::vec3(transforms.scale));
 	}
-	void stop()
+	// the pass's camera, read by every shader through its Camera block until the next pass binds its own.
+	static void bindCamera(const glm::mat4& view, const glm::mat4& proj, const glm::vec3& position)
 	{
-		m_pnu_renderer.stop();
+		FrameStream::bindBlock(UniformBlocks::camera_binding, UniformBlocks::Camera{ .view = view, .projection = proj, .position = glm::vec4(position, 1.0f) })
+			.OnError([](std::string_view error) { std::cerr << "Renderer failed to bind the camera: " << error << '\n'; });
 	}
-	void draw(Scene& scene, float width, float height)
+	// Packs the scene's lights into the frame's PointLights block, read by every lit shader whatever it draws.
+	static void bindPointLights(const std::vector<PointLight>& point_lights)
 	{
-		auto isPNU = [&](MeshVariant& mesh) {
-			return std::holds_alternative<Mesh<MeshType::positions_normals_uvs>>(mesh);
+		UniformBlocks::PointLights block = {};
+		for (const PointLight& light : point_lights | std::views::take(UniformBlocks::max_point_lights)) {
+			block.lights[block.size++] = {
+				.position = light.position,
+				.intensity = light.intensity,
+				.colour = glm::vec3(light.colour),
+				.constant = light.attenuation.constant,
+				.linear = light.attenuation.linear,
+				.quadratic = light.attenuation.quadratic,
+				.ambient_coefficient = light.ambient_coefficient.value_or(0.0f),
+				.specular_exponent = light.specular_exponent.value_or(1.0f),
 			};
-		auto asPNU = [](MeshVariant& mesh) -> Mesh<MeshType::positions_normals_uvs>&{
-			return std::get<Mesh<MeshType::positions_normals_uvs>>(mesh);
-			};
-
-		auto getModelMatrx = [&](const Model::Transforms& transformation) {
-			auto I = glm::mat4(1.0f);
+		}
+		FrameStream::bindBlock(UniformBlocks::point_lights_binding, block)
+			.OnError([](std::string_view error) { std::cerr << "Renderer failed to bind the point lights: " << error << '\n'; });
+	}
+	static auto getDenseId(std::unordered_map<const void*, uint32_t>& ids, const void* key) -> uint32_t
+	{
+		return ids.try_emplace(key, static_cast<uint32_t>(ids.size())).first->second;
+	}
+	void extractPart(Scene& scene, const Model::ModelPart& part, bool is_entity)
+	{
+		const auto& [mesh_key, shader_key, transforms, has_point_lighting, maybe_texture_key] = part;
+		// still loading, see Scene::loadResources.
+		auto meshes_it = scene.m_gpu_mesh_lookup.find(mesh_key);
+		if (meshes_it == scene.m_gpu_mesh_lookup.end()) {
+			return;
+		}
+		auto shader_it = scene.m_shader_lookup.find(shader_key);
+		Texture* texture = (!has_point_lighting && maybe_texture_key) ? &getTextureOrPlaceholder(scene, maybe_texture_key.value()) : nullptr;
 
-			auto A = glm::translate(I, transformation.translation);
-			return glm::scale(A, glm::vec3(transformation.scale));
-			};
+		m_render_items.push_back({
+			.meshes = &meshes_it->second,
+			.shader = (shader_it != scene.m_shader_lookup.end()) ? &shader_it->second : nullptr,
+			.texture = texture,
+			.has_point_lighting = has_point_lighting,
+			.is_transparent = texture && texture->isTranslucent(),
+			.is_entity = is_entity,
+			.model_matrix = getModelMatrix(transforms),
+		});
+	}
+	// Sorts the items the pass draws by their keys, then merges neighbours that share a group into its instances.
+	// Depth only passes ignore the items' shaders and textures. Returns how many groups there are, the first of m_instance_groups.
+	auto groupInstances(const glm::mat4& view, const glm::mat4& proj, float height, bool depth_only, bool include_entities) -> size_t
+	{
+		m_render_queue.clear();
+		m_shader_ids.clear();
+		m_texture_ids.clear();
+		m_mesh_ids.clear();
 
-		auto view = scene.camera.getViewMatrix();
-		auto proj = scene.camera.getProjectionMatrix(width, height);
+		m_lods.resize(m_render_items.size());
+		for (uint32_t i = 0; i < m_render_items.size(); ++i) {
+			const RenderItem& item = m_render_items[i];
+			if ((!depth_only && !item.shader) || (!include_entities && item.is_entity)) {
+				continue;
+			}
+			const glm::mat4 model_view = view * item.model_matrix;
+			m_lods[i] = LodSelection::selectLod(*item.meshes, model_view, proj, height);
 
-		for (Model& model : scene.models) {
-			for (const auto& [mesh_key, shader_key, transforms, has_point_lighting, maybe_texture_key] : model.model_parts) {
-				auto& meshes = scene.m_mesh_lookup[mesh_key];
-				auto& shader = scene.m_shader_lookup[shader_key];
+			const bool is_transparent = !depth_only && item.is_transparent;
+			const uint32_t shader_id = depth_only ? 0 : getDenseId(m_shader_ids, item.shader);
+			const uint32_t texture_id = depth_only ? 0 : getDenseId(m_texture_ids, item.texture);
+			constexpr uint32_t lod_bits = 4;
+			const uint32_t mesh_id = (getDenseId(m_mesh_ids, item.meshes) << lod_bits) | std::min(m_lods[i], (1u << lod_bits) - 1);
+			const uint32_t depth = RenderQueue::quantiseDepth(-model_view[3].z);
+			m_render_queue.push(RenderQueue::makeKey(is_transparent ? RenderQueue::Pass::transparent : RenderQueue::Pass::opaque, shader_id, texture_id, mesh_id, depth), i);
+		}
+		m_render_queue.sort();
 
-				auto model_matrix = getModelMatrx(transforms);
-				shader.bind();
+		size_t group_count = 0;
+		InstanceGroup* group = nullptr;
+		for (const RenderQueue::Entry& entry : m_render_queue.getEntries()) {
+			const RenderItem& item = m_render_items[entry.item];
+			Shader* shader = depth_only ? &m_depth_shader : item.shader;
+			Texture* texture = depth_only ? nullptr : item.texture;
+			const bool has_point_lighting = !depth_only && item.has_point_lighting;
+			const bool is_transparent = !depth_only && item.is_transparent;
 
-				if (!has_point_lighting && !maybe_texture_key) {
-					for (const auto& mesh : meshes | std::views::filter(isPNU) | std::views::transform(asPNU)) {
-						m_pnu_renderer.draw(model_matrix, view, proj, mesh, shader);
-					}
-				}
-				else if (has_point_lighting) {
-					for (const auto& mesh : meshes | std::views::filter(isPNU) | std::views::transform(asPNU)) {
-						m_pnu_renderer.draw(model_matrix, view, proj, mesh, shader, scene.point_lights);
-					}
-				}
-				else if (maybe_texture_key) {
-					scene.m_texture_lookup[maybe_texture_key.value()].bind(2);
-					shader.setUniform("u_texture", int32_t{ 2 });
-					for (const auto& mesh : meshes | std::views::filter(isPNU) | std::views::transform(asPNU)) {
-						m_pnu_renderer.draw(model_matrix, view, proj, mesh, shader);
-					}
+			const bool joins_group = group && group->meshes == item.meshes && group->lod == m_lods[entry.item] && group->shader == shader
+				&& group->texture == texture && group->has_point_lighting == has_point_lighting && group->is_transparent == is_transparent;
+			if (!joins_group) {
+				if (group_count == m_instance_groups.size()) {
+					m_instance_groups.emplace_back();
 				}
+				group = &m_instance_groups[group_count++];
+				group->meshes = item.meshes;
+				group->lod = m_lods[entry.item];
+				group->shader = shader;
+				group->texture = texture;
+				group->has_point_lighting = has_point_lighting;
+				group->is_transparent = is_transparent;
+				group->model_matrices.clear();
 			}
+			group->model_matrices.push_back(item.model_matrix);
+		}
+		return group_count;
+	}
+	void addGroupDraws(const InstanceGroup& group, const glm::mat4& view, const glm::mat4& proj)
+	{
+		for (auto& mesh : *group.meshes) {
+			std::visit([&]<MeshType type>(GpuMesh<type>& typed_mesh) {
+				std::get<MeshRenderer<type>>(m_mesh_renderers).addDraw(group.model_matrices, view, proj, typed_mesh, group.lod);
+			}, mesh);
+		}
+	}
+	// queues every group's meshes and submits them as one batch per layout, from the position streams alone.
+	void drawDepthGroups(size_t group_count, const glm::mat4& view, const glm::mat4& proj, const glm::vec3& position)
+	{
+		bindCamera(view, proj, position);
+		for (const InstanceGroup& group : m_instance_groups | std::views::take(group_count)) {
+			addGroupDraws(group, view, proj);
+		}
+		m_depth_shader.bind();
+		std::apply([&](auto&... mesh_renderers) { (mesh_renderers.submitDepth(), ...); }, m_mesh_renderers);
+	}
+	// submits the draws queued for group's shader and texture.
+	void submitBatch(const InstanceGroup& group)
+	{
+		Shader& shader = *group.shader;
+		shader.bind();
+		if (group.texture) {
+			constexpr static uint64_t texture_uniform = Shader::hashName("u_texture");
+			group.texture->bind(2);
+			shader.getUniform<int32_t>(texture_uniform).OnValue([&](UniformHandle<int32_t> handle) { shader.setUniform(handle, int32_t{ 2 }); });
 		}
+		std::apply([](auto&... mesh_renderers) { (mesh_renderers.submit(), ...); }, m_mesh_renderers);
+	}
+public:
+	void init()
+	{
+		MultiDraw::init();
+		std::apply([](auto&... mesh_renderers) { (mesh_renderers.init(), ...); }, m_mesh_renderers);
 
-		for (auto [model] : scene.entities.forAnyWith<Model>()) {
-			for (const auto& [mesh_key, shader_key, transforms, has_point_lighting, maybe_texture_key] : model.model_parts) {
-				auto& meshes = scene.m_mesh_lookup[mesh_key];
-				auto& shader = scene.m_shader_lookup[shader_key];
+		m_placeholder_texture.init("placeholder", Texture::Image{ .data = { 128, 128, 128, 255 }, .width = 1, .height = 1 });
+		m_placeholder_texture.uploadToGpu();
 
-				auto model_matrix = getModelMatrx(transforms);
-				shader.bind();
+		m_depth_shader.init("assets/shaders/basic.vert.glsl", "assets/shaders/depth.frag.glsl");
+		m_depth_shader.uploadToGpu();
+	}
+	void stop()
+	{
+		m_depth_shader.stop();
+		m_placeholder_texture.stop();
+		std::apply([](auto&... mesh_renderers) { (mesh_renderers.stop(), ...); }, m_mesh_renderers);
+	}
+	// Flattens the scene's models and entities into the frame's items, once per frame before any pass draws.
+	void extract(Scene& scene)
+	{
+		m_render_items.clear();
+		for (Model& model : scene.models) {
+			for (const Model::ModelPart& part : model.model_parts) {
+				extractPart(scene, part, false);
+			}
+		}
+		for (auto [model] : scene.entities.forAnyWith<Model>()) {
+			for (const Model::ModelPart& part : model.model_parts) {
+				extractPart(scene, part, true);
+			}
+		}
+	}
+	// Draws the extracted items as instances, sorted so each shader, texture and mesh is bound once.
+	// Opaque items go front to back, then translucent ones back to front without writing depth.
+	void draw(Scene& scene, float width, float height)
+	{
+		auto view = scene.camera.getViewMatrix();
+		auto proj = scene.camera.getProjectionMatrix(width, height);
+		bindCamera(view, proj, scene.camera.camera_pos);
+		bindPointLights(scene.point_lights);
 
-				if (!has_point_lighting && !maybe_texture_key) {
-					for (const auto& mesh : meshes | std::views::filter(isPNU) | std::views::transform(asPNU)) {
-						m_pnu_renderer.draw(model_matrix, view, proj, mesh, shader);
-					}
-				}
-				else if (has_point_lighting) {
-					for (const auto& mesh : meshes | std::views::filter(isPNU) | std::views::transform(asPNU)) {
-						m_pnu_renderer.draw(model_matrix, view, proj, mesh, shader, scene.point_lights);
-					}
-				}
-				else if (maybe_texture_key) {
-					scene.m_texture_lookup[maybe_texture_key.value()].bind(2);
-					shader.setUniform("u_texture", int32_t{ 2 });
-					for (const auto& mesh : meshes | std::views::filter(isPNU) | std::views::transform(asPNU)) {
-						m_pnu_renderer.draw(model_matrix, view, proj, mesh, shader);
-					}
-				}
+		// neighbouring opaque groups sharing a shader, texture and lighting go out together, a batch per layout.
+		// translucent groups each go out alone, batching would reorder them by layout.
+		const size_t group_count = groupInstances(view, proj, height, false, true);
+		const InstanceGroup* batch = nullptr;
+		for (const InstanceGroup& group : m_instance_groups | std::views::take(group_count)) {
+			const bool shares_batch = batch && !group.is_transparent && batch->shader == group.shader
+				&& batch->texture == group.texture && batch->has_point_lighting == group.has_point_lighting;
+			if (batch && !shares_batch) {
+				submitBatch(*batch);
 			}
+			if (group.is_transparent && !(batch && batch->is_transparent)) {
+				GlState::depthMask(false);
+			}
+			batch = &group;
+			addGroupDraws(group, view, proj);
 		}
+		if (batch) {
+			submitBatch(*batch);
+			if (batch->is_transparent) {
+				GlState::depthMask(true);
+			}
+		}
+	}
+	// the scene's depth from its camera, reading only the meshes' positions.
+	void drawDepth(Scene& scene, float width, float height)
+	{
+		auto view = scene.camera.getViewMatrix();
+		auto proj = scene.camera.getProjectionMatrix(width, height);
+
+		drawDepthGroups(groupInstances(view, proj, height, true, true), view, proj, scene.camera.camera_pos);
 	}
 	void drawShadows(Scene& scene, float width, float height)
 	{
@@ -101,49 +288,9 @@ public:
 		shadow_camera.camera_pos = { -6.13285,10.4158,5.33445 };
 		shadow_camera.camera_dir = { 0.0174524,0.999848,0 };
 
-		auto isPNU = [&](MeshVariant& mesh) {
-			return std::holds_alternative<Mesh<MeshType::positions_normals_uvs>>(mesh);
-			};
-		auto asPNU = [](MeshVariant& mesh) -> Mesh<MeshType::positions_normals_uvs>&{
-			return std::get<Mesh<MeshType::positions_normals_uvs>>(mesh);
-			};
-
-		auto getModelMatrx = [&](const Model::Transforms& transformation) {
-			auto I = glm::mat4(1.0f);
-
-			auto A = glm::translate(I, transformation.translation);
-			return glm::scale(A, glm::vec3(transformation.scale));
-			};
-
 		auto view = shadow_camera.getViewMatrix();
 		auto proj = shadow_camera.getProjectionMatrix(width, height);
 
-		for (Model& model : scene.models) {
-			for (const auto& [mesh_key, shader_key, transforms, has_point_lighting, maybe_texture_key] : model.model_parts) {
-				auto& meshes = scene.m_mesh_lookup[mesh_key];
-				auto& shader = scene.m_shader_lookup[shader_key];
-
-				auto model_matrix = getModelMatrx(transforms);
-				shader.bind();
-
-				if (!has_point_lighting && !maybe_texture_key) {
-					for (const auto& mesh : meshes | std::views::filter(isPNU) | std::views::transform(asPNU)) {
-						m_pnu_renderer.draw(model_matrix, view, proj, mesh, shader);
-					}
-				}
-				else if (has_point_lighting) {
-					for (const auto& mesh : meshes | std::views::filter(isPNU) | std::views::transform(asPNU)) {
-						m_pnu_renderer.draw(model_matrix, view, proj, mesh, shader, scene.point_lights);
-					}
-				}
-				else if (maybe_texture_key) {
-					scene.m_texture_lookup[maybe_texture_key.value()].bind(2);
-					shader.setUniform("u_texture", int32_t{ 2 });
-					for (const auto& mesh : meshes | std::views::filter(isPNU) | std::views::transform(asPNU)) {
-						m_pnu_renderer.draw(model_matrix, view, proj, mesh, shader);
-					}
-				}
-			}
-		}
+		drawDepthGroups(groupInstances(view, proj, height, true, false), view, proj, shadow_camera.camera_pos);
 	}
 };
\ No newline at end of file
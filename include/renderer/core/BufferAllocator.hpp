@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <utility>
+
+// Hands out ranges of a buffer of a fixed capacity, in whatever unit the owner counts in (vertices, indices).
+// Picks the smallest free block that fits and merges freed ranges with their free neighbours,
+// so it only fragments as far as the order of frees forces it to. Compacting means moving the data,
+// which only the owner can do, see GeometryArena::repack.
+class BufferAllocator {
+public:
+	struct Range {
+		uint32_t offset;
+		uint32_t size;
+	};
+
+private:
+	uint32_t m_capacity = 0;
+	uint32_t m_free_size = 0;
+	// offset to size, for finding the neighbours of a freed range.
+	std::map<uint32_t, uint32_t> m_free_by_offset;
+	// (size, offset), for finding the best fit.
+	std::set<std::pair<uint32_t, uint32_t>> m_free_by_size;
+
+	auto addFreeBlock(uint32_t offset, uint32_t size) -> void;
+	auto removeFreeBlock(std::map<uint32_t, uint32_t>::iterator block) -> void;
+
+public:
+	// forgets every allocation, the whole capacity is one free block.
+	auto init(uint32_t capacity) -> void;
+
+	// nullopt when no single free block is large enough, even if the free space in total is.
+	[[nodiscard]] auto allocate(uint32_t size) -> std::optional<Range>;
+	auto free(Range range) -> void;
+
+	auto getCapacity() const noexcept -> uint32_t { return m_capacity; }
+	auto getFreeSize() const noexcept -> uint32_t { return m_free_size; }
+	auto getFreeBlockCount() const noexcept -> size_t { return m_free_by_offset.size(); }
+};
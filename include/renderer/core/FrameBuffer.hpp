@@ -6,8 +6,10 @@
 #include <iostream>
 #include <optional>
 
+#include "renderer/core/GlState.hpp"
 #include "renderer/core/IndexBuffer.hpp"
 #include "renderer/core/Shader.hpp"
+#include "renderer/core/StreamBuffer.hpp"
 #include "renderer/core/VertexArray.hpp"
 #include "renderer/core/VertexBuffer.hpp"
 #include "renderer/core/VertexBufferLayout.hpp"
@@ -17,7 +19,23 @@
 class FrameBuffer;
 class ScreenFrameBuffer;
 
-static Shader* bound_shader = nullptr;
+// two triangles covering the screen, each vertex a position then a uv.
+constexpr auto screen_quad_vertices = std::to_array({ -1.0f, 1.0f, 0.0f, 1.0f,
+	-1.0f, -1.0f, 0.0f, 0.0f,
+	1.0f, -1.0f, 1.0f, 0.0f,
+	-1.0f, 1.0f, 0.0f, 1.0f,
+	1.0f, -1.0f, 1.0f, 0.0f,
+	1.0f, 1.0f, 1.0f, 1.0f });
+constexpr size_t screen_quad_stride = 4 * sizeof(float);
+
+// Streams the screen quad for this frame and draws it with whatever is bound.
+inline void drawScreenQuad()
+{
+	FrameStream::vertices().push(screen_quad_vertices, screen_quad_stride)
+		.OnValue([](StreamSlice& quad) {
+			glDrawArrays(GL_TRIANGLES, quad.getFirst(screen_quad_stride), 6);
+		});
+}
 
 class FrameBuffer {
 	std::optional<uint32_t> m_fb;
@@ -29,7 +47,7 @@ public:
 private:
 	uint32_t m_width, m_height;
 
-	static std::optional<VertexBuffer> m_vb;
+	// reads the screen quad out of FrameStream::vertices().
 	static std::optional<VertexArray> m_va;
 	std::optional<Shader> m_s;
 
@@ -51,15 +69,13 @@ public:
 	void draw(FrameBuffer& fb, std::string_view frag_shader_path)
 	{
 		bind();
-		if (!m_vb.has_value() || !m_va.has_value()) {
-			m_vb = VertexBuffer{};
+		if (!m_va.has_value()) {
 			m_va = VertexArray{};
 
-			m_vb.value().init();
 			m_va.value().init();
 			auto layout = getLayout();
-			m_va.value().attachBufferAndLayout(m_vb.value(), layout);
-			m_vb.value().unbind();
+			m_va.value().attachBufferAndLayout(FrameStream::vertices().getBuffer(), layout);
+			FrameStream::vertices().getBuffer().unbind();
 			m_va.value().unbind();
 		}
 		if (!m_s.has_value()) {
@@ -69,7 +85,6 @@ public:
 			m_s.value().unbind();
 		}
 
-		m_vb.value().bind();
 		m_va.value().bind();
 		m_s.value().bind();
 		static float u_time = 1.0f;
@@ -78,26 +93,16 @@ public:
 
 		m_s.value().setUniform("u_time", u_time);
 
-		bound_shader = &m_s.value();
+		GlState::activeTexture(0);
+		GlState::bindTexture(GL_TEXTURE_2D, fb.m_colour_attachment.value());
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, fb.m_colour_attachment.value());
 
 
-		constexpr static auto vertex_buffer_data = std::to_array({ -1.0f, 1.0f, 0.0f, 1.0f,
-			-1.0f, -1.0f, 0.0f, 0.0f,
-			1.0f, -1.0f, 1.0f, 0.0f,
-			-1.0f, 1.0f, 0.0f, 1.0f,
-			1.0f, -1.0f, 1.0f, 0.0f,
-			1.0f, 1.0f, 1.0f, 1.0f });
-
 		m_s.value().setUniform("u_screen_texture", 0);
-		m_vb.value().loadVertices(vertex_buffer_data);
-
-		glDrawArrays(GL_TRIANGLES, 0, 6);
+		drawScreenQuad();
 
 		m_va.value().unbind();
-		m_vb.value().unbind();
+		FrameStream::vertices().getBuffer().unbind();
 		m_s.value().unbind();
 
 		this->unbind();
@@ -137,7 +142,7 @@ inline void FrameBuffer::init(uint32_t width, uint32_t height)
 	{ // geneate texture/colour attachment.
 		m_colour_attachment = 0;
 		glGenTextures(1, &m_colour_attachment.value());
-		glBindTexture(GL_TEXTURE_2D, m_colour_attachment.value());
+		GlState::bindTexture(GL_TEXTURE_2D, m_colour_attachment.value());
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, m_width, m_height, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -172,12 +177,14 @@ inline void FrameBuffer::init(uint32_t width, uint32_t height)
 inline void FrameBuffer::stop()
 {
 	if (m_colour_attachment) {
+		GlState::forgetTexture(m_colour_attachment.value());
 		glDeleteTextures(1, &m_colour_attachment.value());
 	}
 	if (m_depth_stencil_attachment) {
 		glDeleteRenderbuffers(1, &m_depth_stencil_attachment.value());
 	}
 	if (m_fb) {
+		GlState::forgetFramebuffer(m_fb.value());
 		glDeleteFramebuffers(1, &m_fb.value());
 	}
 	if (m_s) {
@@ -201,12 +208,12 @@ inline void FrameBuffer::bind()
 			exit(EXIT_FAILURE);
 		}
 	}
-	glBindFramebuffer(GL_FRAMEBUFFER, m_fb.value());
-	glViewport(0, 0, m_width, m_height);
+	GlState::bindFramebuffer(GL_FRAMEBUFFER, m_fb.value());
+	GlState::viewport(0, 0, m_width, m_height);
 }
 inline void FrameBuffer::unbind()
 {
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GlState::bindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 
@@ -241,8 +248,8 @@ inline void DepthFrameBuffer::bind()
 			exit(EXIT_FAILURE);
 		}
 	}
-	glBindFramebuffer(GL_FRAMEBUFFER, m_fb.value());
-	glViewport(0, 0, m_width, m_height);
+	GlState::bindFramebuffer(GL_FRAMEBUFFER, m_fb.value());
+	GlState::viewport(0, 0, m_width, m_height);
 }
 inline void DepthFrameBuffer::init(uint32_t width, uint32_t height)
 {
@@ -253,13 +260,13 @@ inline void DepthFrameBuffer::init(uint32_t width, uint32_t height)
 	{ // generate and bind, check for error.
 		m_fb = 0;
 		glGenFramebuffers(1, &m_fb.value());
-		glBindFramebuffer(GL_FRAMEBUFFER, m_fb.value());
+		GlState::bindFramebuffer(GL_FRAMEBUFFER, m_fb.value());
 	}
 
 	{ // geneate texture/colour attachment.
 		m_depth_attachment = 0;
 		glGenTextures(1, &m_depth_attachment.value());
-		glBindTexture(GL_TEXTURE_2D, m_depth_attachment.value());
+		GlState::bindTexture(GL_TEXTURE_2D, m_depth_attachment.value());
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT16, m_width, m_height, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_SHORT, nullptr);
 		// Set texture parameters here (e.g., GL_LINEAR, GL_CLAMP_TO_EDGE)
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -286,11 +293,13 @@ inline void DepthFrameBuffer::init(uint32_t width, uint32_t height)
 inline void DepthFrameBuffer::stop()
 {
 	if (m_depth_attachment) {
+		GlState::forgetTexture(m_depth_attachment.value());
 		glDeleteTextures(1, &m_depth_attachment.value());
 	}
 
 	if (m_fb) {
-		glDeleteFramebuffers(1, &m_depth_attachment.value());
+		GlState::forgetFramebuffer(m_fb.value());
+		glDeleteFramebuffers(1, &m_fb.value());
 	}
 
 	m_depth_attachment = std::nullopt;
@@ -301,7 +310,7 @@ inline void DepthFrameBuffer::stop()
 
 class ScreenFrameBuffer {
 	constexpr static uint32_t m_fb = 0;
-	static VertexBuffer m_vb;
+	// reads the screen quad out of FrameStream::vertices().
 	static VertexArray m_va;
 	static Shader m_s_basic;
 	static Shader m_s_depth;
@@ -317,12 +326,11 @@ class ScreenFrameBuffer {
 public:
 	static void bind()
 	{
-		glBindFramebuffer(GL_FRAMEBUFFER, m_fb);
+		GlState::bindFramebuffer(GL_FRAMEBUFFER, m_fb);
 	}
 	static void init()
 	{
 		ScreenFrameBuffer::stop();
-		m_vb.init();
 		m_va.init();
 		m_s_basic.init("assets/shaders/screen.vert.glsl", "assets/shaders/screen_basic.frag.glsl", std::nullopt);
 		m_s_depth.init("assets/shaders/screen.vert.glsl", "assets/shaders/screen_depth.frag.glsl", std::nullopt);
@@ -331,8 +339,8 @@ public:
 		m_s_depth.uploadToGpu();
 
 		auto layout = getLayout();
-		m_va.attachBufferAndLayout(m_vb, layout);
-		m_vb.unbind();
+		m_va.attachBufferAndLayout(FrameStream::vertices().getBuffer(), layout);
+		FrameStream::vertices().getBuffer().unbind();
 		m_va.unbind();
 		m_s_basic.unbind();
 		m_s_depth.unbind();
@@ -340,7 +348,6 @@ public:
 
 	static void stop()
 	{
-		m_vb.stop();
 		m_va.stop();
 		m_s_basic.stop();
 		m_s_depth.stop();
@@ -357,26 +364,17 @@ public:
 		ScreenFrameBuffer::bind();
 
 		m_va.bind();
-		m_vb.bind();
 		m_s_basic.bind();
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, fb.m_colour_attachment.value());
-
-		constexpr static auto vertex_buffer_data = std::to_array({ -1.0f, 1.0f, 0.0f, 1.0f,
-			-1.0f, -1.0f, 0.0f, 0.0f,
-			1.0f, -1.0f, 1.0f, 0.0f,
-			-1.0f, 1.0f, 0.0f, 1.0f,
-			1.0f, -1.0f, 1.0f, 0.0f,
-			1.0f, 1.0f, 1.0f, 1.0f });
-		m_vb.loadVertices(vertex_buffer_data);
+		GlState::activeTexture(0);
+		GlState::bindTexture(GL_TEXTURE_2D, fb.m_colour_attachment.value());
 
 		m_s_basic.setUniform("u_screen_texture", 0);
 
-		glDrawArrays(GL_TRIANGLES, 0, 6);
+		drawScreenQuad();
 
 		m_va.unbind();
-		m_vb.unbind();
+		FrameStream::vertices().getBuffer().unbind();
 		m_s_basic.unbind();
 	}
 
@@ -385,36 +383,25 @@ public:
 		ScreenFrameBuffer::bind();
 
 		m_va.bind();
-		m_vb.bind();
 		m_s_depth.bind();
 
-		glActiveTexture(GL_TEXTURE0);
+		GlState::activeTexture(0);
 
-		glBindTexture(GL_TEXTURE_2D, fb.m_depth_attachment.value());
+		GlState::bindTexture(GL_TEXTURE_2D, fb.m_depth_attachment.value());
 
-		constexpr static auto vertex_buffer_data = std::to_array({ -1.0f, 1.0f, 0.0f, 1.0f,
-			-1.0f, -1.0f, 0.0f, 0.0f,
-			1.0f, -1.0f, 1.0f, 0.0f,
-			-1.0f, 1.0f, 0.0f, 1.0f,
-			1.0f, -1.0f, 1.0f, 0.0f,
-			1.0f, 1.0f, 1.0f, 1.0f });
 
 		m_s_depth.setUniform("u_screen_texture", 0);
 
-		m_vb.loadVertices(vertex_buffer_data);
-
-		glDrawArrays(GL_TRIANGLES, 0, 6);
+		drawScreenQuad();
 
 		m_va.unbind();
-		m_vb.unbind();
+		FrameStream::vertices().getBuffer().unbind();
 		m_s_depth.unbind();
 	}
 };
 
-inline std::optional<VertexBuffer> FrameBuffer::m_vb = {};
 inline std::optional<VertexArray> FrameBuffer::m_va = {};
 
-inline VertexBuffer ScreenFrameBuffer::m_vb = {};
 inline VertexArray ScreenFrameBuffer::m_va = {};
 inline Shader ScreenFrameBuffer::m_s_basic = {};
 inline Shader ScreenFrameBuffer::m_s_depth = {};
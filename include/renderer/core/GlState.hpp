@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Libraries.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+// Mirrors the context's binding and fixed function state, so calls that wouldn't change anything never reach GL.
+// Every renderer/core wrapper changes state through here. State changed behind its back must be followed
+// by invalidate(), and deleted objects forgotten, GL unbinds them itself.
+// Element array buffer bindings belong to the bound vertex array, so they are unknown after every vertex array change.
+namespace GlState {
+	// of the calls made through GlState since the last resetStats(), debug builds print them every few seconds.
+	struct Stats {
+		uint64_t issued = 0;
+		uint64_t skipped = 0;
+	};
+
+	auto getStats() noexcept -> const Stats&;
+	auto resetStats() noexcept -> void;
+	// forgets everything, the next call of each kind reaches GL.
+	auto invalidate() noexcept -> void;
+
+	auto useProgram(uint32_t program) noexcept -> void;
+	auto bindVertexArray(uint32_t vertex_array) noexcept -> void;
+	// array, element array, copy, indirect and uniform buffers are cached, other targets always reach GL.
+	auto bindBuffer(uint32_t target, uint32_t buffer) noexcept -> void;
+	// ranges bound to the uniform buffer binding points are cached, other indexed targets always reach GL.
+	auto bindBufferRange(uint32_t target, uint32_t index, uint32_t buffer, size_t offset_in_bytes, size_t size_in_bytes) noexcept -> void;
+	auto activeTexture(uint32_t unit) noexcept -> void;
+	// to the active unit, only GL_TEXTURE_2D bindings are cached.
+	auto bindTexture(uint32_t target, uint32_t texture) noexcept -> void;
+	// GL_FRAMEBUFFER binds both the draw and the read framebuffer.
+	auto bindFramebuffer(uint32_t target, uint32_t framebuffer) noexcept -> void;
+	auto viewport(int32_t x, int32_t y, int32_t width, int32_t height) noexcept -> void;
+
+	// GL_BLEND, GL_DEPTH_TEST and GL_CULL_FACE are cached, other capabilities always reach GL.
+	auto setEnabled(uint32_t capability, bool is_enabled) noexcept -> void;
+	auto blendFunc(uint32_t source_factor, uint32_t destination_factor) noexcept -> void;
+	auto depthFunc(uint32_t func) noexcept -> void;
+	auto depthMask(bool is_writing) noexcept -> void;
+	auto cullFace(uint32_t mode) noexcept -> void;
+
+	// call when deleting, so a new object reusing the name isn't taken as already bound.
+	auto forgetProgram(uint32_t program) noexcept -> void;
+	auto forgetVertexArray(uint32_t vertex_array) noexcept -> void;
+	auto forgetBuffer(uint32_t buffer) noexcept -> void;
+	auto forgetTexture(uint32_t texture) noexcept -> void;
+	auto forgetFramebuffer(uint32_t framebuffer) noexcept -> void;
+}
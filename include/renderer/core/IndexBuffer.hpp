@@ -6,6 +6,7 @@
 #include <iostream>
 #include <optional>
 #include <span>
+#include <utility>
 
 #include "BuildSettings.hpp"
 #include "Concept.hpp"
@@ -14,6 +15,7 @@ class IndexBuffer {
 private:
 	std::optional<uint32_t> m_ibo;
 	uint32_t m_index_count;
+	uint32_t m_index_type;
 public:
 	~IndexBuffer();
 
@@ -22,7 +24,7 @@ public:
 	auto bind() noexcept -> void;
 	auto unbind() noexcept -> void;
 
-	auto loadIndices(const Concept::IsContiguousRangeWithUnderlyingType<uint32_t> auto& indices) noexcept -> void
+	auto loadIndices(const Concept::IsContiguousRangeWithUnderlyingType<uint32_t> auto& indices, uint32_t usage = GL_DYNAMIC_DRAW) noexcept -> void
 	{
 		if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
 			if (!m_ibo) {
@@ -32,8 +34,37 @@ public:
 		}
 		size_t size_in_bytes = indices.size() * sizeof(uint32_t);
 		this->bind();
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, size_in_bytes, indices.data(), GL_DYNAMIC_DRAW);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, size_in_bytes, indices.data(), usage);
 		m_index_count = indices.size();
+		m_index_type = GL_UNSIGNED_INT;
+	}
+	auto loadIndices(const Concept::IsContiguousRangeWithUnderlyingType<uint16_t> auto& indices, uint32_t usage = GL_DYNAMIC_DRAW) noexcept -> void
+	{
+		if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+			if (!m_ibo) {
+				std::cerr << "IndexBuffer failed, trying to \"load indices\" into an unitialised index buffer object.";
+				exit(EXIT_FAILURE);
+			}
+		}
+		size_t size_in_bytes = indices.size() * sizeof(uint16_t);
+		this->bind();
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, size_in_bytes, indices.data(), usage);
+		m_index_count = indices.size();
+		m_index_type = GL_UNSIGNED_SHORT;
+	}
+	// sizes the buffer for index_count 32 bit indices without filling it, for loadSubIndices.
+	auto reserve(uint32_t index_count, uint32_t usage = GL_STATIC_DRAW) noexcept -> void;
+	// overwrites indices from first_index on, the buffer must already be large enough.
+	auto loadSubIndices(uint32_t first_index, std::span<const uint32_t> indices) noexcept -> void;
+	// copies between two different buffers on the gpu, counted in indices.
+	auto copyFrom(IndexBuffer& source, uint32_t source_first_index, uint32_t first_index, uint32_t index_count) noexcept -> void;
+	// exchanges the buffer objects, copies would both delete the same one.
+	auto swap(IndexBuffer& other) noexcept -> void
+	{
+		std::swap(m_ibo, other.m_ibo);
+		std::swap(m_index_count, other.m_index_count);
+		std::swap(m_index_type, other.m_index_type);
 	}
 	auto getIndexCount() const noexcept -> uint32_t { return m_index_count; }
+	auto getIndexType() const noexcept -> uint32_t { return m_index_type; }
 };
\ No newline at end of file
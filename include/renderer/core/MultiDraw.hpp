@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Libraries.hpp"
+
+#include <cstdint>
+#include <span>
+
+// One indexed draw, laid out as GL's DrawElementsIndirectCommand so native can source it straight from a buffer.
+struct DrawElementsIndirectCommand {
+	uint32_t count;
+	uint32_t instance_count;
+	uint32_t first_index;
+	int32_t base_vertex;
+	// where the draw's instances start in the per instance attributes, which is how each draw finds its own data.
+	uint32_t base_instance;
+};
+static_assert(sizeof(DrawElementsIndirectCommand) == 20);
+
+// Submits a batch of indexed draws from the bound vertex array in as few calls as the context allows.
+// Native uses glMultiDrawElementsIndirect, WebGL2 the multi draw extension that takes base instances,
+// and either falls back to a draw per command without them.
+namespace MultiDraw {
+	enum class Path {
+		// one call for the whole batch.
+		multi_draw,
+		// a call per command, each offsetting its instances itself.
+		base_instance_loop,
+		// a call per command, the per instance attributes are rebound for each.
+		loop,
+	};
+
+	// picks the path from the current context's extensions.
+	auto init() noexcept -> void;
+	auto getPath() noexcept -> Path;
+
+	// for the multi_draw and base_instance_loop paths.
+	auto drawWithBaseInstances(std::span<const DrawElementsIndirectCommand> commands, uint32_t index_type, uint32_t index_size) noexcept -> void;
+	// draws one command as if its base instance were zero.
+	auto drawWithoutBaseInstance(const DrawElementsIndirectCommand& command, uint32_t index_type, uint32_t index_size) noexcept -> void;
+
+	// Draws every command. bind_instances(first_instance) rebinds the per instance attributes from
+	// first_instance on, it's only called when the path can't offset them itself.
+	template <typename BindInstances>
+	auto drawElements(std::span<const DrawElementsIndirectCommand> commands, uint32_t index_type, uint32_t index_size, BindInstances&& bind_instances) noexcept -> void
+	{
+		if (getPath() != Path::loop) {
+			drawWithBaseInstances(commands, index_type, index_size);
+			return;
+		}
+		for (const DrawElementsIndirectCommand& command : commands) {
+			bind_instances(command.base_instance);
+			drawWithoutBaseInstance(command, index_type, index_size);
+		}
+	}
+}
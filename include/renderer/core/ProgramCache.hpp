@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Libraries.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+
+#include "Expected.hpp"
+
+// Linked programs saved as the driver's own binaries, so later runs load them instead of compiling and linking.
+//
+// A binary is keyed by a hash of the program's preprocessed sources and of the driver's vendor, renderer and
+// version strings, so editing a shader or updating the driver misses and the program is compiled again. Drivers may
+// still reject a binary they wrote, the program is then compiled from source and the binary replaced.
+// Native only, WebGL2 has no program binaries.
+//
+// File layout: FileHeader, then binary_size bytes of the binary.
+namespace ProgramCache {
+	// bump whenever the file layout changes.
+	constexpr uint32_t version = 1;
+	constexpr std::array<char, 4> magic = { 'W', 'P', 'R', 'G' };
+	constexpr std::string_view extension = ".wprog";
+	inline const std::filesystem::path cache_directory = "assets/cache/programs";
+
+	struct FileHeader {
+		std::array<char, 4> magic;
+		uint32_t version;
+		uint64_t key;
+		uint32_t binary_format;
+		uint32_t binary_size;
+	};
+
+	// of the programs uploaded since the last resetStats().
+	struct Stats {
+		uint32_t hits = 0;
+		// nothing cached for the program, or only for other sources or another driver.
+		uint32_t misses = 0;
+		// cached binaries the driver wouldn't load.
+		uint32_t rejections = 0;
+		// by how they were uploaded, see recordUpload. Without binary support every program is compiled,
+		// with no hit or miss counted.
+		uint32_t loaded = 0;
+		uint32_t compiled = 0;
+		std::chrono::duration<double, std::milli> loading_time = {};
+		std::chrono::duration<double, std::milli> compiling_time = {};
+	};
+
+	auto getStats() noexcept -> const Stats&;
+	auto resetStats() noexcept -> void;
+	// how long a program took to upload, by whether it was loaded from its binary.
+	auto recordUpload(bool was_loaded, std::chrono::duration<double, std::milli> time) noexcept -> void;
+
+	// whether the driver can save and load at least one binary format, needs a current context.
+	auto isSupported() noexcept -> bool;
+	// sources are the program's stages exactly as they are compiled.
+	auto makeKey(std::span<const std::string_view> sources) noexcept -> uint64_t;
+
+	// Loads program from its binary, counting the hit, miss or rejection. Fails when there's no usable binary,
+	// program is then unlinked, and can be compiled and linked as if it was never tried.
+	auto load(uint32_t program, uint64_t key) noexcept -> Expected<void, std::string_view>;
+	// Saves a linked program, which should have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set.
+	// Writes to a temporary file first and renames it into place, so a reader never sees a half written file.
+	auto store(uint32_t program, uint64_t key) noexcept -> Expected<void, std::string_view>;
+}
@@ -2,18 +2,76 @@
 
 #include "Libraries.hpp"
 
-#include <filesystem>
-#include <unordered_map>
+#include <array>
+#include <concepts>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
 #include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
+#include <glm/glm.hpp>
+
+#include "BuildSettings.hpp"
 #include "Expected.hpp"
 
+// The types a uniform can be set from, int32_t also sets samplers.
+template <typename T>
+concept UniformValue = std::same_as<T, glm::mat4> || std::same_as<T, glm::vec3> || std::same_as<T, float> || std::same_as<T, int32_t>;
+
+// A uniform's index in the reflected table of the shader it was got from, valid until that shader is reloaded.
+template <UniformValue T>
+struct UniformHandle {
+	uint32_t index;
+};
+
 class Shader
 {
+public:
+	// FNV-1a, so a name can be hashed at compile time and looked up with getUniform without building a string.
+	constexpr static auto hashName(std::string_view name) noexcept -> uint64_t
+	{
+		uint64_t hash = 0xcbf29ce484222325;
+		for (char c : name) {
+			hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3;
+		}
+		return hash;
+	}
+
+private:
+	// Every active uniform outside a block, reflected once linked. Array elements each get an entry of their own,
+	// and the array's name without [0] shares the first element's location.
+	struct ReflectedUniform {
+		std::string name;
+		uint64_t name_hash;
+		int32_t location;
+		uint32_t type;
+		// the last value set, so setting it again doesn't reach GL.
+		std::array<std::byte, sizeof(glm::mat4)> value;
+		bool has_value;
+	};
+	struct ReflectedBlock {
+		std::string name;
+		uint32_t index;
+		// GL_UNIFORM_BLOCK_DATA_SIZE, the smallest range that can be bound to it.
+		size_t size_in_bytes;
+	};
+	struct ReflectedAttribute {
+		std::string name;
+		int32_t location;
+		uint32_t type;
+	};
+
 	std::optional<int32_t> m_program_id;
-    std::unordered_map<size_t, int32_t> m_uniforms_lookup;
-	
+	// sorted by name_hash, names are unique per program so no two share one.
+	std::vector<ReflectedUniform> m_uniforms;
+	std::vector<ReflectedBlock> m_blocks;
+	std::vector<ReflectedAttribute> m_attributes;
+
 	std::filesystem::path m_vert_shader_path;
 	std::filesystem::path m_frag_shader_path;
 	std::optional<std::filesystem::path> m_geo_shader_path;
@@ -28,12 +86,84 @@ public:
 	void reload() noexcept;
 	void stop() noexcept;
 
+	// Resolves a uniform once, so setting it is an index and a compare. Fails when the program has no
+	// such active uniform, or it isn't of type T.
+	template <UniformValue T>
+	auto getUniform(std::string_view name) const -> Expected<UniformHandle<T>, std::string_view>
+	{
+		if (auto index = findUniform(name); index) {
+			return checkType<T>(index.value());
+		}
+		return { name };
+	}
+	// name_hash should come from hashName.
+	template <UniformValue T>
+	auto getUniform(uint64_t name_hash) const -> Expected<UniformHandle<T>, std::string_view>
+	{
+		if (auto index = findUniform(name_hash); index) {
+			return checkType<T>(index.value());
+		}
+		return { "The program has no active uniform with that name hash." };
+	}
+	// binds the shader, unless the uniform already holds value.
+	template <UniformValue T>
+	void setUniform(UniformHandle<T> handle, const T& value) noexcept
+	{
+		if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+			if (handle.index >= m_uniforms.size()) {
+				std::cerr << "Trying to set a uniform through a handle from another shader, or from before a reload.\n"
+						  << std::endl;
+				exit(EXIT_FAILURE);
+			}
+		}
+		ReflectedUniform& uniform = m_uniforms[handle.index];
+		if (uniform.has_value && std::memcmp(uniform.value.data(), &value, sizeof(T)) == 0) {
+			return;
+		}
+		std::memcpy(uniform.value.data(), &value, sizeof(T));
+		uniform.has_value = true;
+
+		this->bind();
+		uploadUniform(uniform.location, value);
+	}
+
+	// looks the uniform up on every call, prefer a handle from getUniform for anything set per draw.
 	auto setUniform(const std::string_view& key, const glm::mat4& value) -> Expected<void, std::string_view>;
 	auto setUniform(const std::string_view& key, const glm::vec3& value) -> Expected<void, std::string_view>;
 	auto setUniform(const std::string_view& key, const float value) -> Expected<void, std::string_view>;
 	auto setUniform(const std::string_view& key, const int32_t value) -> Expected<void, std::string_view>;
 
+	auto getAttributeLocation(std::string_view name) const -> Expected<int32_t, std::string_view>;
+
 	~Shader();
 private:
-	auto getUniformIndex(const std::string_view& key) -> Expected<int32_t, std::string_view>;
-};
\ No newline at end of file
+	// fills the tables from the linked program and binds its blocks, see UniformBlocks.
+	void reflect() noexcept;
+	auto findUniform(std::string_view name) const noexcept -> std::optional<uint32_t>;
+	auto findUniform(uint64_t name_hash) const noexcept -> std::optional<uint32_t>;
+
+	template <UniformValue T>
+	auto checkType(uint32_t index) const -> Expected<UniformHandle<T>, std::string_view>
+	{
+		const uint32_t type = m_uniforms[index].type;
+		bool is_of_type = false;
+		if constexpr (std::same_as<T, glm::mat4>) {
+			is_of_type = type == GL_FLOAT_MAT4;
+		} else if constexpr (std::same_as<T, glm::vec3>) {
+			is_of_type = type == GL_FLOAT_VEC3;
+		} else if constexpr (std::same_as<T, float>) {
+			is_of_type = type == GL_FLOAT;
+		} else {
+			is_of_type = type == GL_INT || type == GL_BOOL || type == GL_SAMPLER_2D || type == GL_SAMPLER_CUBE || type == GL_SAMPLER_2D_SHADOW;
+		}
+		if (!is_of_type) {
+			return { "The uniform's type doesn't match the one it's being set from." };
+		}
+		return UniformHandle<T>{ index };
+	}
+
+	static void uploadUniform(int32_t location, const glm::mat4& value) noexcept;
+	static void uploadUniform(int32_t location, const glm::vec3& value) noexcept;
+	static void uploadUniform(int32_t location, float value) noexcept;
+	static void uploadUniform(int32_t location, int32_t value) noexcept;
+};
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "Libraries.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <ranges>
+#include <string_view>
+#include <type_traits>
+
+#include "BuildSettings.hpp"
+#include "Expected.hpp"
+#include "renderer/core/IndexBuffer.hpp"
+#include "renderer/core/UniformBuffer.hpp"
+#include "renderer/core/VertexBuffer.hpp"
+
+// Where a push landed, valid until the end of the frame it was pushed in.
+struct StreamSlice {
+	size_t offset_in_bytes;
+	size_t size_in_bytes;
+
+	// the first vertex for glDrawArrays, or the first index for glDrawElements, when pushed aligned to element_size.
+	auto getFirst(size_t element_size) const noexcept -> int32_t { return static_cast<int32_t>(offset_in_bytes / element_size); }
+	auto getPointer() const noexcept -> const void* { return reinterpret_cast<const void*>(offset_in_bytes); }
+};
+
+// A buffer for data that is written every frame, split into one region per frame in flight so the
+// gpu can still be reading the last frames' regions while this one is written. Nothing is reallocated,
+// pushes are written into the current region and stay valid until endFrame().
+//
+// Native writes with unsynchronised glMapBufferRange and fences each region at the end of its frame,
+// beginFrame() only waits when the gpu is still frames_in_flight frames behind. WebGL2 can't map,
+// there the pushes go through glBufferSubData and the browser does the synchronising.
+// Buffer is VertexBuffer, IndexBuffer or UniformBuffer, bind getBuffer() to draw from it.
+template <typename Buffer>
+class StreamBuffer {
+public:
+	constexpr static size_t frames_in_flight = 3;
+
+private:
+	constexpr static uint32_t target = std::is_same_v<Buffer, IndexBuffer> ? GL_ELEMENT_ARRAY_BUFFER
+		: std::is_same_v<Buffer, UniformBuffer> ? GL_UNIFORM_BUFFER
+		: GL_ARRAY_BUFFER;
+
+	Buffer m_buffer;
+	size_t m_region_size = 0;
+	size_t m_region_index = 0;
+	// bytes of the current region already pushed.
+	size_t m_cursor = 0;
+#if BUILD_TARGET == NATIVE_BUILD
+	// signalled once the gpu has finished with each region's frame.
+	std::array<GLsync, frames_in_flight> m_fences = {};
+#endif
+
+public:
+	auto init(size_t bytes_per_frame) noexcept -> void
+	{
+		stop();
+		m_buffer.init();
+		if constexpr (std::is_same_v<Buffer, IndexBuffer>) {
+			m_buffer.reserve(static_cast<uint32_t>(bytes_per_frame * frames_in_flight / sizeof(uint32_t)), GL_STREAM_DRAW);
+		} else {
+			m_buffer.reserve(bytes_per_frame * frames_in_flight, GL_STREAM_DRAW);
+		}
+		m_buffer.unbind();
+		m_region_size = bytes_per_frame;
+		m_region_index = 0;
+		m_cursor = 0;
+	}
+	auto stop() noexcept -> void
+	{
+#if BUILD_TARGET == NATIVE_BUILD
+		for (GLsync& fence : m_fences) {
+			if (fence) {
+				glDeleteSync(fence);
+				fence = nullptr;
+			}
+		}
+#endif
+		m_buffer.stop();
+		m_region_size = 0;
+	}
+
+	// Waits for the gpu to finish with the region this frame reuses.
+	auto beginFrame() noexcept -> void
+	{
+#if BUILD_TARGET == NATIVE_BUILD
+		if (GLsync& fence = m_fences[m_region_index]; fence) {
+			constexpr uint64_t timeout_ns = 1'000'000;
+			while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout_ns) == GL_TIMEOUT_EXPIRED) {
+			}
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+#endif
+		m_cursor = 0;
+	}
+	// Fences the frame's region, call once the frame's draws have been issued.
+	auto endFrame() noexcept -> void
+	{
+#if BUILD_TARGET == NATIVE_BUILD
+		m_fences[m_region_index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#endif
+		m_region_index = (m_region_index + 1) % frames_in_flight;
+	}
+
+	// Copies data into the frame's region. alignment should be the size of a vertex or an index,
+	// so the slice can be addressed by StreamSlice::getFirst, or UniformBuffer::getOffsetAlignment() for a block. Binds the buffer to its target, push
+	// indices with no vertex array bound, or the one that will draw them.
+	template <std::ranges::contiguous_range Range>
+		requires std::is_trivially_copyable_v<std::ranges::range_value_t<Range>>
+	[[nodiscard]] auto push(const Range& data, size_t alignment = alignof(std::ranges::range_value_t<Range>)) noexcept -> Expected<StreamSlice, std::string_view>
+	{
+		const size_t size_in_bytes = std::ranges::size(data) * sizeof(std::ranges::range_value_t<Range>);
+		const size_t aligned_cursor = (m_cursor + alignment - 1) / alignment * alignment;
+		if (aligned_cursor + size_in_bytes > m_region_size) {
+			if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+				std::cerr << "StreamBuffer failed, a frame pushed more than the " << m_region_size << " bytes of its region.\n";
+				exit(EXIT_FAILURE);
+			}
+			return { "The frame's stream buffer region is full." };
+		}
+		const size_t offset_in_bytes = m_region_index * m_region_size + aligned_cursor;
+		m_cursor = aligned_cursor + size_in_bytes;
+
+		m_buffer.bind();
+#if BUILD_TARGET == NATIVE_BUILD
+		// the region's fence has passed, so nothing the gpu still reads can be overwritten.
+		void* mapped = glMapBufferRange(target, offset_in_bytes, size_in_bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+		// fails on a lost context or when the driver is out of memory.
+		if (mapped == nullptr) {
+			return { "Failed to map the frame's stream buffer region." };
+		}
+		std::memcpy(mapped, std::ranges::data(data), size_in_bytes);
+		glUnmapBuffer(target);
+#elif BUILD_TARGET == WEB_BUILD
+		glBufferSubData(target, offset_in_bytes, size_in_bytes, std::ranges::data(data));
+#endif
+		return StreamSlice{ .offset_in_bytes = offset_in_bytes, .size_in_bytes = size_in_bytes };
+	}
+
+	auto getBuffer() noexcept -> Buffer& { return m_buffer; }
+};
+
+// The stream buffers shared by every transient draw, such as the frame buffers' screen quads.
+// Set up with the main context, and begun and ended around each frame.
+namespace FrameStream {
+	constexpr size_t vertex_bytes_per_frame = 4 * 1024 * 1024;
+	constexpr size_t index_bytes_per_frame = 256 * 1024;
+	constexpr size_t uniform_bytes_per_frame = 64 * 1024;
+
+	auto vertices() noexcept -> StreamBuffer<VertexBuffer>&;
+	auto indices() noexcept -> StreamBuffer<IndexBuffer>&;
+	auto uniforms() noexcept -> StreamBuffer<UniformBuffer>&;
+	// Pushes a block into the frame's uniforms and binds it to the block's binding point, see UniformBlocks.
+	template <typename Block>
+		requires std::is_trivially_copyable_v<Block>
+	auto bindBlock(uint32_t binding, const Block& block) noexcept -> Expected<void, std::string_view>
+	{
+		auto result = uniforms().push(std::array { block }, UniformBuffer::getOffsetAlignment());
+		if (result.HasError()) {
+			return { result.Error() };
+		}
+		uniforms().getBuffer().bindRange(binding, result.Value().offset_in_bytes, result.Value().size_in_bytes);
+		return {};
+	}
+
+	auto init() noexcept -> void;
+	auto stop() noexcept -> void;
+	auto beginFrame() noexcept -> void;
+	auto endFrame() noexcept -> void;
+}
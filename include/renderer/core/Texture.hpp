@@ -1,23 +1,31 @@
 #pragma once
 
 #include "Libraries.hpp"
+#include "Expected.hpp"
 
 #include <filesystem>
 #include <optional>
 #include <cstdint>
+#include <string_view>
 #include <vector>
 
 class Texture {
+public:
+	// decoded rgba8 pixels.
 	struct Image {
 		std::vector<uint8_t> data;
 		uint32_t width;
 		uint32_t height;
 	};
+
+private:
 	std::filesystem::path m_texture_path;
 
 	std::optional<Image> m_image;
 	std::optional<uint32_t> m_texture_id;
 	std::optional<uint32_t> m_bound_slot;
+	// whether any texel of the image is less than opaque.
+	bool m_is_translucent = false;
 
 public:
 	void uploadToGpu() noexcept;
@@ -27,14 +35,23 @@ public:
 	void unbind() noexcept;
 
 	void init(std::filesystem::path texture_path) noexcept;
+	// adopts an image that was already decoded, e.g. by loadImage on a worker thread.
+	void init(std::filesystem::path texture_path, Image image) noexcept;
 	void reload() noexcept;
 	void stop() noexcept;
 
+	// translucent textures are drawn after everything opaque, back to front, see RenderQueue.
+	auto isTranslucent() const noexcept -> bool { return m_is_translucent; }
+
 	Texture();
 	//Texture(const Texture&) = delete;
 	//Texture(Texture&&) noexcept;
 
 	~Texture() { stop(); }
+	// Reads and decodes the png, touches no gl state so is safe to call from any thread.
+	static auto loadImage(const std::filesystem::path& texture_path) noexcept -> Expected<Image, std::string_view>;
+
 private:
 	void loadImageFromDisk();
+	static auto hasTranslucentTexels(const Image& image) noexcept -> bool;
 };
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Libraries.hpp"
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string_view>
+
+#include <glm/glm.hpp>
+
+#include "BuildSettings.hpp"
+
+// The uniform blocks shared by every shader. Each block name is bound to its binding point when a
+// shader is linked, see Shader::uploadToGpu, so a buffer range bound there once is seen by every program.
+namespace UniformBlocks {
+    constexpr uint32_t camera_binding = 0;
+    constexpr uint32_t point_lights_binding = 1;
+
+    // std140, matches assets/shaders/common/camera.glsl. Written once per pass.
+    struct Camera {
+        glm::mat4 view;
+        glm::mat4 projection;
+        // w is unused, a vec3 would be padded to 16 bytes anyway.
+        glm::vec4 position;
+    };
+    static_assert(sizeof(Camera) == 144);
+
+    // std140, matches assets/shaders/common/point_lights.glsl. Each vec3 shares its 16 bytes with the float after it.
+    struct PointLight {
+        glm::vec3 position;
+        float intensity;
+        glm::vec3 colour;
+        float constant;
+        float linear;
+        float quadratic;
+        float ambient_coefficient;
+        float specular_exponent;
+    };
+    static_assert(sizeof(PointLight) == 48);
+
+    // Written once per frame, lights past max_point_lights are dropped.
+    constexpr uint32_t max_point_lights = 10;
+    struct PointLights {
+        std::array<PointLight, max_point_lights> lights;
+        int32_t size;
+        // std140 rounds the block up to a multiple of 16 bytes.
+        std::array<int32_t, 3> padding;
+    };
+    static_assert(sizeof(PointLights) == 496);
+
+    struct Binding {
+        std::string_view name;
+        uint32_t binding;
+        // of the C++ struct, a program's block mustn't need more than is bound.
+        size_t size_in_bytes;
+    };
+    constexpr auto bindings = std::array {
+        Binding { "Camera", camera_binding, sizeof(Camera) },
+        Binding { "PointLights", point_lights_binding, sizeof(PointLights) },
+    };
+}
+
+class UniformBuffer {
+private:
+    std::optional<uint32_t> m_ubo;
+
+public:
+    auto init() noexcept -> void;
+    auto stop() noexcept -> void;
+    auto bind() noexcept -> void;
+    auto unbind() noexcept -> void;
+
+    // sizes the buffer without filling it.
+    auto reserve(size_t size_in_bytes, uint32_t usage = GL_DYNAMIC_DRAW) noexcept -> void;
+    // binds part of the buffer to a block binding point, offset_in_bytes must be a multiple of getOffsetAlignment().
+    auto bindRange(uint32_t binding, size_t offset_in_bytes, size_t size_in_bytes) noexcept -> void;
+
+    // GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, queried once a context is current.
+    static auto getOffsetAlignment() noexcept -> size_t;
+
+    ~UniformBuffer();
+};
@@ -22,7 +22,10 @@ public:
     auto bind() noexcept -> void;
     auto unbind() noexcept -> void;
 
-    auto attachBufferAndLayout(VertexBuffer& vb, VertexBufferLayout& layout) -> void;
+    // the layout's attributes take the locations from first_location up, so a vertex array can read
+    // several buffers by attaching each after the attributes of the last. the attributes are read from
+    // offset_in_bytes on, advancing once per vertex or, with a divisor, once per that many instances.
+    auto attachBufferAndLayout(VertexBuffer& vb, VertexBufferLayout& layout, uint32_t first_location = 0, size_t offset_in_bytes = 0, uint32_t divisor = 0) -> void;
 
     ~VertexArray();
 };
\ No newline at end of file
@@ -5,7 +5,10 @@
 #include <cstdint>
 #include <iostream>
 #include <optional>
+#include <ranges>
 #include <span>
+#include <type_traits>
+#include <utility>
 
 #include "BuildSettings.hpp"
 #include "Concept.hpp"
@@ -19,8 +22,13 @@ public:
     auto stop() noexcept -> void;
     auto bind() noexcept -> void;
     auto unbind() noexcept -> void;
+    // binds the buffer to another target, such as GL_DRAW_INDIRECT_BUFFER, to read what was written into it as vertices.
+    auto bindAs(uint32_t target) noexcept -> void;
 
-    auto loadVertices(const Concept::IsContiguousRangeWithUnderlyingType<float> auto& vertices) noexcept -> void
+    // vertices can be floats or any packed vertex struct, the layout attached alongside says how to read them.
+    template <std::ranges::contiguous_range Range>
+        requires std::is_trivially_copyable_v<std::ranges::range_value_t<Range>>
+    auto loadVertices(const Range& vertices, uint32_t usage = GL_DYNAMIC_DRAW) noexcept -> void
     {
         if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
             if (!m_vbo) {
@@ -28,10 +36,26 @@ public:
                 exit(EXIT_FAILURE);
             }
         }
-        size_t size_in_bytes = vertices.size() * sizeof(float);
+        size_t size_in_bytes = std::ranges::size(vertices) * sizeof(std::ranges::range_value_t<Range>);
         this->bind();
-        glBufferData(GL_ARRAY_BUFFER, size_in_bytes, vertices.data(), GL_DYNAMIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, size_in_bytes, std::ranges::data(vertices), usage);
     }
-    
+
+    // sizes the buffer without filling it, for loadSubVertices.
+    auto reserve(size_t size_in_bytes, uint32_t usage = GL_STATIC_DRAW) noexcept -> void;
+    // overwrites part of a buffer, which must already be large enough.
+    template <std::ranges::contiguous_range Range>
+        requires std::is_trivially_copyable_v<std::ranges::range_value_t<Range>>
+    auto loadSubVertices(size_t offset_in_bytes, const Range& vertices) noexcept -> void
+    {
+        size_t size_in_bytes = std::ranges::size(vertices) * sizeof(std::ranges::range_value_t<Range>);
+        this->bind();
+        glBufferSubData(GL_ARRAY_BUFFER, offset_in_bytes, size_in_bytes, std::ranges::data(vertices));
+    }
+    // copies between two different buffers on the gpu.
+    auto copyFrom(VertexBuffer& source, size_t source_offset_in_bytes, size_t offset_in_bytes, size_t size_in_bytes) noexcept -> void;
+    // exchanges the buffer objects, copies would both delete the same one.
+    auto swap(VertexBuffer& other) noexcept -> void { std::swap(m_vbo, other.m_vbo); }
+
     ~VertexBuffer();
 };
\ No newline at end of file
@@ -4,9 +4,14 @@
 
 #include <cassert>
 #include <cstdint>
-#include <stdexcept>
+#include <type_traits>
 #include <vector>
 
+// A 16 bit float as stored in a vertex buffer, pushed as GL_HALF_FLOAT.
+struct HalfFloat {
+    uint16_t bits;
+};
+
 struct VertexBufferElement {
     uint32_t count;
     uint32_t type;
@@ -19,6 +24,16 @@ struct VertexBufferElement {
             return sizeof(float);
         case GL_UNSIGNED_INT:
             return sizeof(uint32_t);
+        case GL_HALF_FLOAT:
+            return sizeof(HalfFloat);
+        case GL_SHORT:
+            return sizeof(int16_t);
+        case GL_UNSIGNED_SHORT:
+            return sizeof(uint16_t);
+        case GL_BYTE:
+            return sizeof(int8_t);
+        case GL_UNSIGNED_BYTE:
+            return sizeof(uint8_t);
         default:
             assert(false);
             return 0;
@@ -38,21 +53,35 @@ public:
     {
     }
 
+    // normalised integer attributes are read by the shader as floats in [-1, 1] (signed) or [0, 1] (unsigned).
     template <typename T>
-    constexpr void push(uint32_t count)
-    {
-        throw std::runtime_error("\'VertexBufferLayout.hpp\': Unimplemented buffer layout push");
-    }
-    template <>
-    constexpr void push<float>(uint32_t count)
+    constexpr void push(uint32_t count, bool normalised = false)
     {
-        elements.push_back({ count, GL_FLOAT, GL_FALSE });
-        stride += sizeof(float) * count;
+        constexpr uint32_t type = getGlType<T>();
+        elements.push_back({ count, type, static_cast<uint32_t>(normalised ? GL_TRUE : GL_FALSE) });
+        stride += sizeof(T) * count;
     }
-    template <>
-    constexpr void push<uint32_t>(uint32_t count)
+
+private:
+    template <typename T>
+    constexpr static auto getGlType() -> uint32_t
     {
-        elements.push_back({ count, GL_UNSIGNED_INT, GL_FALSE });
-        stride += sizeof(uint32_t) * count;
+        if constexpr (std::is_same_v<T, float>) {
+            return GL_FLOAT;
+        } else if constexpr (std::is_same_v<T, uint32_t>) {
+            return GL_UNSIGNED_INT;
+        } else if constexpr (std::is_same_v<T, HalfFloat>) {
+            return GL_HALF_FLOAT;
+        } else if constexpr (std::is_same_v<T, int16_t>) {
+            return GL_SHORT;
+        } else if constexpr (std::is_same_v<T, uint16_t>) {
+            return GL_UNSIGNED_SHORT;
+        } else if constexpr (std::is_same_v<T, int8_t>) {
+            return GL_BYTE;
+        } else if constexpr (std::is_same_v<T, uint8_t>) {
+            return GL_UNSIGNED_BYTE;
+        } else {
+            static_assert(!sizeof(T), "'VertexBufferLayout.hpp': Unimplemented buffer layout push");
+        }
     }
 };
@@ -0,0 +1,548 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <span>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+// Locale free number parsing for text assets.
+// Unlike std::stof nothing is copied or allocated, and unlike std::from_chars<float> it is available
+// under emscripten's libc++, so every build target parses numbers the same way.
+namespace wm::parse {
+
+namespace detail {
+    struct Uint128 {
+        uint64_t low;
+        uint64_t high;
+    };
+
+    inline auto fullMultiplication(uint64_t a, uint64_t b) noexcept -> Uint128
+    {
+#if defined(__SIZEOF_INT128__)
+        unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+        return { static_cast<uint64_t>(product), static_cast<uint64_t>(product >> 64) };
+#elif defined(_MSC_VER) && defined(_M_X64)
+        uint64_t high;
+        uint64_t low = _umul128(a, b, &high);
+        return { low, high };
+#else
+        uint64_t a_low = a & 0xFFFFFFFF, a_high = a >> 32;
+        uint64_t b_low = b & 0xFFFFFFFF, b_high = b >> 32;
+        uint64_t low_low = a_low * b_low;
+        uint64_t high_low = a_high * b_low;
+        uint64_t low_high = a_low * b_high;
+        uint64_t high_high = a_high * b_high;
+        uint64_t middle = (low_low >> 32) + (high_low & 0xFFFFFFFF) + low_high;
+        return { (middle << 32) | (low_low & 0xFFFFFFFF), high_high + (high_low >> 32) + (middle >> 32) };
+#endif
+    }
+
+    // binary32 constants.
+    constexpr int mantissa_explicit_bits = 23;
+    constexpr int minimum_exponent = -127;
+    constexpr int infinite_power = 0xFF;
+    constexpr int min_exponent_round_to_even = -17;
+    constexpr int max_exponent_round_to_even = 10;
+    // any w * 10^q below this is closer to zero than to the smallest subnormal, above the largest is infinite.
+    constexpr int smallest_power_of_ten = -64;
+    constexpr int largest_power_of_ten = 38;
+
+    // The 128 most significant bits of 5^q for q in [smallest_power_of_ten, largest_power_of_ten],
+    // rounded up for negative q. Generated as described in "Number Parsing at a Gigabyte per Second"
+    // (Lemire 2021), limited to the range a binary32 can need.
+    inline constexpr std::array<uint64_t, 2 * (largest_power_of_ten - smallest_power_of_ten + 1)> power_of_five_128 = {
+    0xa87fea27a539e9a5, 0x3f2398d747b36224, // 5^-64
+    0xd29fe4b18e88640e, 0x8eec7f0d19a03aad, // 5^-63
+    0x83a3eeeef9153e89, 0x1953cf68300424ac, // 5^-62
+    0xa48ceaaab75a8e2b, 0x5fa8c3423c052dd7, // 5^-61
+    0xcdb02555653131b6, 0x3792f412cb06794d, // 5^-60
+    0x808e17555f3ebf11, 0xe2bbd88bbee40bd0, // 5^-59
+    0xa0b19d2ab70e6ed6, 0x5b6aceaeae9d0ec4, // 5^-58
+    0xc8de047564d20a8b, 0xf245825a5a445275, // 5^-57
+    0xfb158592be068d2e, 0xeed6e2f0f0d56712, // 5^-56
+    0x9ced737bb6c4183d, 0x55464dd69685606b, // 5^-55
+    0xc428d05aa4751e4c, 0xaa97e14c3c26b886, // 5^-54
+    0xf53304714d9265df, 0xd53dd99f4b3066a8, // 5^-53
+    0x993fe2c6d07b7fab, 0xe546a8038efe4029, // 5^-52
+    0xbf8fdb78849a5f96, 0xde98520472bdd033, // 5^-51
+    0xef73d256a5c0f77c, 0x963e66858f6d4440, // 5^-50
+    0x95a8637627989aad, 0xdde7001379a44aa8, // 5^-49
+    0xbb127c53b17ec159, 0x5560c018580d5d52, // 5^-48
+    0xe9d71b689dde71af, 0xaab8f01e6e10b4a6, // 5^-47
+    0x9226712162ab070d, 0xcab3961304ca70e8, // 5^-46
+    0xb6b00d69bb55c8d1, 0x3d607b97c5fd0d22, // 5^-45
+    0xe45c10c42a2b3b05, 0x8cb89a7db77c506a, // 5^-44
+    0x8eb98a7a9a5b04e3, 0x77f3608e92adb242, // 5^-43
+    0xb267ed1940f1c61c, 0x55f038b237591ed3, // 5^-42
+    0xdf01e85f912e37a3, 0x6b6c46dec52f6688, // 5^-41
+    0x8b61313bbabce2c6, 0x2323ac4b3b3da015, // 5^-40
+    0xae397d8aa96c1b77, 0xabec975e0a0d081a, // 5^-39
+    0xd9c7dced53c72255, 0x96e7bd358c904a21, // 5^-38
+    0x881cea14545c7575, 0x7e50d64177da2e54, // 5^-37
+    0xaa242499697392d2, 0xdde50bd1d5d0b9e9, // 5^-36
+    0xd4ad2dbfc3d07787, 0x955e4ec64b44e864, // 5^-35
+    0x84ec3c97da624ab4, 0xbd5af13bef0b113e, // 5^-34
+    0xa6274bbdd0fadd61, 0xecb1ad8aeacdd58e, // 5^-33
+    0xcfb11ead453994ba, 0x67de18eda5814af2, // 5^-32
+    0x81ceb32c4b43fcf4, 0x80eacf948770ced7, // 5^-31
+    0xa2425ff75e14fc31, 0xa1258379a94d028d, // 5^-30
+    0xcad2f7f5359a3b3e, 0x096ee45813a04330, // 5^-29
+    0xfd87b5f28300ca0d, 0x8bca9d6e188853fc, // 5^-28
+    0x9e74d1b791e07e48, 0x775ea264cf55347e, // 5^-27
+    0xc612062576589dda, 0x95364afe032a819e, // 5^-26
+    0xf79687aed3eec551, 0x3a83ddbd83f52205, // 5^-25
+    0x9abe14cd44753b52, 0xc4926a9672793543, // 5^-24
+    0xc16d9a0095928a27, 0x75b7053c0f178294, // 5^-23
+    0xf1c90080baf72cb1, 0x5324c68b12dd6339, // 5^-22
+    0x971da05074da7bee, 0xd3f6fc16ebca5e04, // 5^-21
+    0xbce5086492111aea, 0x88f4bb1ca6bcf585, // 5^-20
+    0xec1e4a7db69561a5, 0x2b31e9e3d06c32e6, // 5^-19
+    0x9392ee8e921d5d07, 0x3aff322e62439fd0, // 5^-18
+    0xb877aa3236a4b449, 0x09befeb9fad487c3, // 5^-17
+    0xe69594bec44de15b, 0x4c2ebe687989a9b4, // 5^-16
+    0x901d7cf73ab0acd9, 0x0f9d37014bf60a11, // 5^-15
+    0xb424dc35095cd80f, 0x538484c19ef38c95, // 5^-14
+    0xe12e13424bb40e13, 0x2865a5f206b06fba, // 5^-13
+    0x8cbccc096f5088cb, 0xf93f87b7442e45d4, // 5^-12
+    0xafebff0bcb24aafe, 0xf78f69a51539d749, // 5^-11
+    0xdbe6fecebdedd5be, 0xb573440e5a884d1c, // 5^-10
+    0x89705f4136b4a597, 0x31680a88f8953031, // 5^-9
+    0xabcc77118461cefc, 0xfdc20d2b36ba7c3e, // 5^-8
+    0xd6bf94d5e57a42bc, 0x3d32907604691b4d, // 5^-7
+    0x8637bd05af6c69b5, 0xa63f9a49c2c1b110, // 5^-6
+    0xa7c5ac471b478423, 0x0fcf80dc33721d54, // 5^-5
+    0xd1b71758e219652b, 0xd3c36113404ea4a9, // 5^-4
+    0x83126e978d4fdf3b, 0x645a1cac083126ea, // 5^-3
+    0xa3d70a3d70a3d70a, 0x3d70a3d70a3d70a4, // 5^-2
+    0xcccccccccccccccc, 0xcccccccccccccccd, // 5^-1
+    0x8000000000000000, 0x0000000000000000, // 5^0
+    0xa000000000000000, 0x0000000000000000, // 5^1
+    0xc800000000000000, 0x0000000000000000, // 5^2
+    0xfa00000000000000, 0x0000000000000000, // 5^3
+    0x9c40000000000000, 0x0000000000000000, // 5^4
+    0xc350000000000000, 0x0000000000000000, // 5^5
+    0xf424000000000000, 0x0000000000000000, // 5^6
+    0x9896800000000000, 0x0000000000000000, // 5^7
+    0xbebc200000000000, 0x0000000000000000, // 5^8
+    0xee6b280000000000, 0x0000000000000000, // 5^9
+    0x9502f90000000000, 0x0000000000000000, // 5^10
+    0xba43b74000000000, 0x0000000000000000, // 5^11
+    0xe8d4a51000000000, 0x0000000000000000, // 5^12
+    0x9184e72a00000000, 0x0000000000000000, // 5^13
+    0xb5e620f480000000, 0x0000000000000000, // 5^14
+    0xe35fa931a0000000, 0x0000000000000000, // 5^15
+    0x8e1bc9bf04000000, 0x0000000000000000, // 5^16
+    0xb1a2bc2ec5000000, 0x0000000000000000, // 5^17
+    0xde0b6b3a76400000, 0x0000000000000000, // 5^18
+    0x8ac7230489e80000, 0x0000000000000000, // 5^19
+    0xad78ebc5ac620000, 0x0000000000000000, // 5^20
+    0xd8d726b7177a8000, 0x0000000000000000, // 5^21
+    0x878678326eac9000, 0x0000000000000000, // 5^22
+    0xa968163f0a57b400, 0x0000000000000000, // 5^23
+    0xd3c21bcecceda100, 0x0000000000000000, // 5^24
+    0x84595161401484a0, 0x0000000000000000, // 5^25
+    0xa56fa5b99019a5c8, 0x0000000000000000, // 5^26
+    0xcecb8f27f4200f3a, 0x0000000000000000, // 5^27
+    0x813f3978f8940984, 0x4000000000000000, // 5^28
+    0xa18f07d736b90be5, 0x5000000000000000, // 5^29
+    0xc9f2c9cd04674ede, 0xa400000000000000, // 5^30
+    0xfc6f7c4045812296, 0x4d00000000000000, // 5^31
+    0x9dc5ada82b70b59d, 0xf020000000000000, // 5^32
+    0xc5371912364ce305, 0x6c28000000000000, // 5^33
+    0xf684df56c3e01bc6, 0xc732000000000000, // 5^34
+    0x9a130b963a6c115c, 0x3c7f400000000000, // 5^35
+    0xc097ce7bc90715b3, 0x4b9f100000000000, // 5^36
+    0xf0bdc21abb48db20, 0x1e86d40000000000, // 5^37
+    0x96769950b50d88f4, 0x1314448000000000, // 5^38
+    };
+
+    struct Decimal {
+        uint64_t mantissa = 0;
+        int64_t exponent = 0;
+        bool is_negative = false;
+        // more than 19 significant digits, the mantissa only holds the leading ones.
+        bool too_many_digits = false;
+        bool is_valid = false;
+    };
+
+    inline auto isDigit(char c) noexcept -> bool
+    {
+        return static_cast<unsigned char>(c - '0') < 10;
+    }
+
+    // Reads [sign] digits [. digits] [(e|E) [sign] digits] as mantissa * 10^exponent.
+    inline auto parseDecimal(const char* p, const char* last) noexcept -> Decimal
+    {
+        Decimal decimal;
+        if (p != last && (*p == '-' || *p == '+')) {
+            decimal.is_negative = (*p == '-');
+            ++p;
+        }
+
+        uint64_t mantissa = 0;
+        const char* integer_begin = p;
+        for (; p != last && isDigit(*p); ++p) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+        }
+        const char* integer_end = p;
+        int64_t digit_count = integer_end - integer_begin;
+
+        int64_t exponent = 0;
+        const char* fraction_begin = p;
+        const char* fraction_end = p;
+        if (p != last && *p == '.') {
+            ++p;
+            fraction_begin = p;
+            for (; p != last && isDigit(*p); ++p) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+            }
+            fraction_end = p;
+            exponent = fraction_begin - fraction_end;
+            digit_count -= exponent;
+        }
+        if (digit_count == 0) {
+            return decimal;
+        }
+
+        int64_t explicit_exponent = 0;
+        if (p != last && (*p == 'e' || *p == 'E')) {
+            const char* exponent_begin = p;
+            ++p;
+            bool exponent_is_negative = false;
+            if (p != last && (*p == '-' || *p == '+')) {
+                exponent_is_negative = (*p == '-');
+                ++p;
+            }
+            if (p == last || !isDigit(*p)) {
+                // not an exponent after all, e.g. "1e".
+                p = exponent_begin;
+            }
+            else {
+                for (; p != last && isDigit(*p); ++p) {
+                    if (explicit_exponent < 0x10000000) {
+                        explicit_exponent = explicit_exponent * 10 + (*p - '0');
+                    }
+                }
+                if (exponent_is_negative) {
+                    explicit_exponent = -explicit_exponent;
+                }
+                exponent += explicit_exponent;
+            }
+        }
+
+        if (digit_count > 19) {
+            // leading zeros are not significant.
+            for (const char* start = integer_begin; start != fraction_end && (*start == '0' || *start == '.'); ++start) {
+                digit_count -= (*start == '0');
+            }
+            if (digit_count > 19) {
+                // keep the leading 19 digits and move the rest into the exponent.
+                decimal.too_many_digits = true;
+                constexpr uint64_t minimal_nineteen_digit_integer = 1000000000000000000;
+                mantissa = 0;
+                const char* q = integer_begin;
+                for (; mantissa < minimal_nineteen_digit_integer && q != integer_end; ++q) {
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(*q - '0');
+                }
+                if (mantissa >= minimal_nineteen_digit_integer) {
+                    exponent = (integer_end - q) + explicit_exponent;
+                }
+                else {
+                    q = fraction_begin;
+                    for (; mantissa < minimal_nineteen_digit_integer && q != fraction_end; ++q) {
+                        mantissa = mantissa * 10 + static_cast<uint64_t>(*q - '0');
+                    }
+                    exponent = (fraction_begin - q) + explicit_exponent;
+                }
+            }
+        }
+        decimal.mantissa = mantissa;
+        decimal.exponent = exponent;
+        decimal.is_valid = true;
+        return decimal;
+    }
+
+    struct AdjustedMantissa {
+        uint64_t mantissa = 0;
+        int32_t power2 = 0;
+
+        bool operator==(const AdjustedMantissa& other) const = default;
+    };
+
+    // Eisel-Lemire: the correctly rounded binary32 nearest to w * 10^q for w < 10^19.
+    inline auto computeFloat(int64_t q, uint64_t w) noexcept -> AdjustedMantissa
+    {
+        AdjustedMantissa answer;
+        if (w == 0 || q < smallest_power_of_ten) {
+            return answer;
+        }
+        if (q > largest_power_of_ten) {
+            answer.power2 = infinite_power;
+            return answer;
+        }
+
+        const int leading_zeros = std::countl_zero(w);
+        w <<= leading_zeros;
+
+        // only the top mantissa_explicit_bits + 3 bits of the product need to be exact.
+        constexpr int bit_precision = mantissa_explicit_bits + 3;
+        constexpr uint64_t precision_mask = ~uint64_t { 0 } >> bit_precision;
+        const size_t index = 2 * static_cast<size_t>(q - smallest_power_of_ten);
+        Uint128 product = fullMultiplication(w, power_of_five_128[index]);
+        if ((product.high & precision_mask) == precision_mask) {
+            Uint128 second_product = fullMultiplication(w, power_of_five_128[index + 1]);
+            product.low += second_product.high;
+            if (second_product.high > product.low) {
+                ++product.high;
+            }
+        }
+
+        const int upper_bit = static_cast<int>(product.high >> 63);
+        const int shift = upper_bit + 64 - mantissa_explicit_bits - 3;
+        answer.mantissa = product.high >> shift;
+        // floor(log2(10^q)) + 63, exact over the table's range.
+        const int32_t power_of_two = static_cast<int32_t>(((152170 + 65536) * q) >> 16) + 63;
+        answer.power2 = power_of_two + upper_bit - leading_zeros - minimum_exponent;
+
+        if (answer.power2 <= 0) {
+            // subnormal.
+            if (-answer.power2 + 1 >= 64) {
+                return {};
+            }
+            answer.mantissa >>= -answer.power2 + 1;
+            answer.mantissa += (answer.mantissa & 1);
+            answer.mantissa >>= 1;
+            answer.power2 = (answer.mantissa < (uint64_t { 1 } << mantissa_explicit_bits)) ? 0 : 1;
+            return answer;
+        }
+
+        // exactly halfway between two floats, round to even.
+        if (product.low <= 1 && q >= min_exponent_round_to_even && q <= max_exponent_round_to_even && (answer.mantissa & 3) == 1) {
+            if ((answer.mantissa << shift) == product.high) {
+                answer.mantissa &= ~uint64_t { 1 };
+            }
+        }
+
+        answer.mantissa += (answer.mantissa & 1);
+        answer.mantissa >>= 1;
+        if (answer.mantissa >= (uint64_t { 2 } << mantissa_explicit_bits)) {
+            answer.mantissa = uint64_t { 1 } << mantissa_explicit_bits;
+            ++answer.power2;
+        }
+        answer.mantissa &= ~(uint64_t { 1 } << mantissa_explicit_bits);
+        if (answer.power2 >= infinite_power) {
+            return { 0, infinite_power };
+        }
+        return answer;
+    }
+
+    // Just large enough for the slow path's comparisons, which need under 600 bits.
+    struct BigInteger {
+        std::array<uint32_t, 64> limbs {};
+        size_t size = 0;
+
+        explicit BigInteger(uint64_t value) noexcept
+        {
+            for (; value != 0; value >>= 32) {
+                limbs[size++] = static_cast<uint32_t>(value);
+            }
+        }
+
+        auto multiplyAdd(uint32_t factor, uint32_t addend) noexcept -> void
+        {
+            uint64_t carry = addend;
+            for (size_t i = 0; i < size; ++i) {
+                const uint64_t product = uint64_t { limbs[i] } * factor + carry;
+                limbs[i] = static_cast<uint32_t>(product);
+                carry = product >> 32;
+            }
+            if (carry != 0 && size < limbs.size()) {
+                limbs[size++] = static_cast<uint32_t>(carry);
+            }
+        }
+
+        auto multiplyByPowerOfFive(uint32_t power) noexcept -> void
+        {
+            // 5^13 is the largest power of five that fits a limb.
+            constexpr uint32_t five_to_the_13 = 1220703125;
+            for (; power >= 13; power -= 13) {
+                multiplyAdd(five_to_the_13, 0);
+            }
+            uint32_t factor = 1;
+            for (; power > 0; --power) {
+                factor *= 5;
+            }
+            multiplyAdd(factor, 0);
+        }
+
+        auto shiftLeft(uint32_t bits) noexcept -> void
+        {
+            const size_t limb_shift = std::min<size_t>(bits / 32, limbs.size());
+            const uint32_t bit_shift = bits % 32;
+            if (bit_shift != 0 && size != 0) {
+                uint32_t carry = 0;
+                for (size_t i = 0; i < size; ++i) {
+                    const uint32_t limb = limbs[i];
+                    limbs[i] = (limb << bit_shift) | carry;
+                    carry = limb >> (32 - bit_shift);
+                }
+                if (carry != 0 && size < limbs.size()) {
+                    limbs[size++] = carry;
+                }
+            }
+            if (limb_shift != 0 && size != 0) {
+                size = std::min(size + limb_shift, limbs.size());
+                std::copy_backward(limbs.begin(), limbs.begin() + static_cast<std::ptrdiff_t>(size - limb_shift), limbs.begin() + static_cast<std::ptrdiff_t>(size));
+                std::fill_n(limbs.begin(), limb_shift, 0u);
+            }
+        }
+
+        friend auto compare(const BigInteger& a, const BigInteger& b) noexcept -> int
+        {
+            if (a.size != b.size) {
+                return (a.size < b.size) ? -1 : 1;
+            }
+            for (size_t i = a.size; i-- > 0;) {
+                if (a.limbs[i] != b.limbs[i]) {
+                    return (a.limbs[i] < b.limbs[i]) ? -1 : 1;
+                }
+            }
+            return 0;
+        }
+    };
+
+    // Decides between the float below, lower, and the one above it by comparing every digit of the text
+    // against the exact halfway point between them, for when the leading 19 digits can't.
+    // Halfway points of binary32 have at most 112 significant digits, so the digits past max_digits only
+    // matter in whether any of them is non zero.
+    inline auto roundByDigits(const char* p, const char* last, uint32_t lower) noexcept -> uint32_t
+    {
+        constexpr int64_t max_digits = 114;
+        p += (p != last && (*p == '-' || *p == '+'));
+
+        BigInteger digits { 0 };
+        int64_t kept = 0;
+        int64_t exponent = 0;
+        bool is_truncated = false;
+        bool is_fraction = false;
+        for (; p != last && (isDigit(*p) || (*p == '.' && !is_fraction)); ++p) {
+            if (*p == '.') {
+                is_fraction = true;
+                continue;
+            }
+            exponent -= is_fraction;
+            const uint32_t digit = static_cast<uint32_t>(*p - '0');
+            if (kept == 0 && digit == 0) {
+                continue;
+            }
+            if (kept < max_digits) {
+                digits.multiplyAdd(10, digit);
+                ++kept;
+            }
+            else {
+                ++exponent;
+                is_truncated |= (digit != 0);
+            }
+        }
+        if (p != last && (*p == 'e' || *p == 'E')) {
+            ++p;
+            const bool exponent_is_negative = (p != last && *p == '-');
+            p += (p != last && (*p == '-' || *p == '+'));
+            int64_t explicit_exponent = 0;
+            for (; p != last && isDigit(*p); ++p) {
+                if (explicit_exponent < 0x10000000) {
+                    explicit_exponent = explicit_exponent * 10 + (*p - '0');
+                }
+            }
+            exponent += exponent_is_negative ? -explicit_exponent : explicit_exponent;
+        }
+        if (is_truncated) {
+            // anything past the kept digits lies strictly between them and the next kept value.
+            digits.multiplyAdd(10, 1);
+            --exponent;
+        }
+
+        // halfway = (2 * significand + 1) * 2^(binary_exponent - 1)
+        const uint32_t biased_exponent = lower >> mantissa_explicit_bits;
+        const uint32_t fraction = lower & ((uint32_t { 1 } << mantissa_explicit_bits) - 1);
+        const uint64_t significand = (biased_exponent == 0) ? fraction : (fraction | (uint32_t { 1 } << mantissa_explicit_bits));
+        const int64_t binary_exponent = (biased_exponent == 0) ? -149 : int64_t { biased_exponent } - 150;
+        BigInteger halfway { 2 * significand + 1 };
+        const int64_t halfway_exponent = binary_exponent - 1;
+
+        // digits * 2^exponent * 5^exponent against halfway * 2^halfway_exponent, with every factor an integer.
+        if (exponent >= 0) {
+            digits.multiplyByPowerOfFive(static_cast<uint32_t>(exponent));
+        }
+        else {
+            halfway.multiplyByPowerOfFive(static_cast<uint32_t>(-exponent));
+        }
+        if (exponent >= halfway_exponent) {
+            digits.shiftLeft(static_cast<uint32_t>(exponent - halfway_exponent));
+        }
+        else {
+            halfway.shiftLeft(static_cast<uint32_t>(halfway_exponent - exponent));
+        }
+
+        const int order = compare(digits, halfway);
+        if (order == 0) {
+            return lower + (lower & 1);
+        }
+        return (order < 0) ? lower : lower + 1;
+    }
+}
+
+// Parses a signed decimal integer, stopping at the first character that isn't a digit.
+// Returns 0 when there are no digits. Overflow wraps, indices in text assets never get near it.
+inline auto toInt(std::span<const char> text) noexcept -> int32_t
+{
+    const char* p = text.data();
+    const char* last = text.data() + text.size();
+    const bool is_negative = (p != last && *p == '-');
+    p += (p != last && (*p == '-' || *p == '+'));
+
+    uint32_t value = 0;
+    for (; p != last && detail::isDigit(*p); ++p) {
+        value = value * 10 + static_cast<uint32_t>(*p - '0');
+    }
+    return static_cast<int32_t>(is_negative ? 0u - value : value);
+}
+
+// Parses a decimal float, rounded to nearest like std::from_chars(..., std::chars_format::general).
+// Returns 0 when there are no digits.
+inline auto toFloat(std::span<const char> text) noexcept -> float
+{
+    const detail::Decimal decimal = detail::parseDecimal(text.data(), text.data() + text.size());
+    if (!decimal.is_valid) {
+        return 0.0f;
+    }
+
+    // Clinger's fast path: both w and 10^|q| are exact floats, so a single float operation rounds correctly.
+    constexpr std::array<float, 11> exact_powers_of_ten = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+    if (!decimal.too_many_digits && decimal.exponent >= -10 && decimal.exponent <= 10 && decimal.mantissa <= (uint64_t { 1 } << 24)) {
+        float value = static_cast<float>(decimal.mantissa);
+        if (decimal.exponent < 0) {
+            value /= exact_powers_of_ten[static_cast<size_t>(-decimal.exponent)];
+        }
+        else {
+            value *= exact_powers_of_ten[static_cast<size_t>(decimal.exponent)];
+        }
+        return decimal.is_negative ? -value : value;
+    }
+
+    const detail::AdjustedMantissa answer = detail::computeFloat(decimal.exponent, decimal.mantissa);
+    uint32_t bits = static_cast<uint32_t>(answer.mantissa) | (static_cast<uint32_t>(answer.power2) << detail::mantissa_explicit_bits);
+    if (decimal.too_many_digits && answer != detail::computeFloat(decimal.exponent, decimal.mantissa + 1)) {
+        // the dropped digits decide between this float and the next, only more than 19 significant digits get here.
+        bits = detail::roundByDigits(text.data(), text.data() + text.size(), bits);
+    }
+    return std::bit_cast<float>(bits | (static_cast<uint32_t>(decimal.is_negative) << 31));
+}
+
+}
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define WM_SCAN_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define WM_SCAN_SSE2 1
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define WM_SCAN_WASM_SIMD 1
+#endif
+#if WM_SCAN_SSE2 || WM_SCAN_WASM_SIMD
+#define WM_SCAN_SIMD 1
+#endif
+
+#if defined(_MSC_VER)
+#define WM_FORCE_INLINE __forceinline
+#else
+#define WM_FORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+namespace wm::scan {
+
+template <size_t N>
+WM_FORCE_INLINE auto isDelim(char c, const std::array<char, N>& delims) noexcept -> bool
+{
+    bool is_delim = false;
+    for (char delim : delims) {
+        is_delim |= (c == delim);
+    }
+    return is_delim;
+}
+
+#if WM_SCAN_SIMD
+// Bit i of the result is set when p[i] is one of the delimiters, for 16 bytes at p.
+template <size_t N>
+WM_FORCE_INLINE auto blockMask16(const char* p, const std::array<char, N>& delims) noexcept -> uint32_t
+{
+#if WM_SCAN_SSE2
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i matches = _mm_setzero_si128();
+    for (char delim : delims) {
+        matches = _mm_or_si128(matches, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(delim)));
+    }
+    return static_cast<uint32_t>(_mm_movemask_epi8(matches));
+#elif WM_SCAN_WASM_SIMD
+    v128_t chunk = wasm_v128_load(p);
+    v128_t matches = wasm_i64x2_splat(0);
+    for (char delim : delims) {
+        matches = wasm_v128_or(matches, wasm_i8x16_eq(chunk, wasm_i8x16_splat(delim)));
+    }
+    return wasm_i8x16_bitmask(matches);
+#endif
+}
+#endif
+
+#if WM_SCAN_AVX2
+// Bit i of the result is set when p[i] is one of the delimiters, for 32 bytes at p.
+template <size_t N>
+WM_FORCE_INLINE auto blockMask32(const char* p, const std::array<char, N>& delims) noexcept -> uint32_t
+{
+    __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i matches = _mm256_setzero_si256();
+    for (char delim : delims) {
+        matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(delim)));
+    }
+    return static_cast<uint32_t>(_mm256_movemask_epi8(matches));
+}
+#endif
+
+// Finds the first byte in [first, last) that is one of the delimiters, or with MatchDelims = false
+// the first byte that is none of them. Returns last when there is no such byte.
+template <bool MatchDelims, size_t N>
+WM_FORCE_INLINE auto findFirstOf(const char* first, const char* last, const std::array<char, N>& delims) noexcept -> const char*
+{
+#if WM_SCAN_SIMD
+    // most searches in short tokens end on the first byte, so don't pay for a block load for those.
+    if (first == last || isDelim(*first, delims) == MatchDelims) {
+        return first;
+    }
+    const char* range_begin = first;
+    ++first;
+
+#if WM_SCAN_AVX2
+    while (last - first >= 32) {
+        uint32_t mask = blockMask32(first, delims);
+        if constexpr (!MatchDelims) {
+            mask = ~mask;
+        }
+        if (mask != 0) {
+            return first + std::countr_zero(mask);
+        }
+        first += 32;
+    }
+#endif
+    while (last - first >= 16) {
+        uint32_t mask = blockMask16(first, delims);
+        if constexpr (!MatchDelims) {
+            mask = ~mask & 0xFFFFu;
+        }
+        if (mask != 0) {
+            return first + std::countr_zero(mask);
+        }
+        first += 16;
+    }
+    if (first != last && last - range_begin >= 16) {
+        // re-read the last full block of the range, dropping the bytes that were already checked.
+        uint32_t mask = blockMask16(last - 16, delims);
+        if constexpr (!MatchDelims) {
+            mask = ~mask & 0xFFFFu;
+        }
+        mask >>= 16 - (last - first);
+        return (mask != 0) ? first + std::countr_zero(mask) : last;
+    }
+#endif
+    for (; first != last; ++first) {
+        if (isDelim(*first, delims) == MatchDelims) {
+            return first;
+        }
+    }
+    return last;
+}
+
+// Splits [first, last) on runs of the delimiters in one pass, writing at most tokens.size() tokens.
+// Returns how many tokens were written.
+template <size_t N>
+WM_FORCE_INLINE auto tokenize(const char* first, const char* last, const std::array<char, N>& delims, std::span<std::span<const char>> tokens) noexcept -> size_t
+{
+    size_t count = 0;
+    bool in_token = false;
+    const char* token_begin = first;
+
+#if WM_SCAN_SIMD
+    // Works on 64 byte windows: the delimiter bitmask of a window gives every token start (a non delimiter
+    // after a delimiter) and end (a delimiter after a non delimiter) at once.
+    constexpr size_t window_size = 64;
+    const size_t total_size = static_cast<size_t>(last - first);
+    // whether the byte before the window was part of a token.
+    uint64_t carry = 0;
+
+    for (const char* window = first; window < last && count < tokens.size(); window += window_size) {
+        const size_t size = std::min(window_size, static_cast<size_t>(last - window));
+        const uint64_t valid = (size == window_size) ? ~uint64_t { 0 } : ((uint64_t { 1 } << size) - 1);
+
+        uint64_t delim_mask = 0;
+        for (size_t offset = 0; offset < size; offset += 16) {
+            const size_t block_bytes = std::min(size_t { 16 }, size - offset);
+            uint32_t block_mask = 0;
+            if (block_bytes == 16) {
+                block_mask = blockMask16(window + offset, delims);
+            }
+            else if (total_size >= 16) {
+                // re-read the last full block of the range rather than finishing the tail a byte at a time.
+                block_mask = blockMask16(last - 16, delims) >> (16 - block_bytes);
+            }
+            else {
+                for (size_t i = 0; i < block_bytes; ++i) {
+                    block_mask |= static_cast<uint32_t>(isDelim(window[offset + i], delims)) << i;
+                }
+            }
+            delim_mask |= static_cast<uint64_t>(block_mask) << offset;
+        }
+        delim_mask &= valid;
+
+        const uint64_t token_bytes = ~delim_mask & valid;
+        const uint64_t previous_token_bytes = (token_bytes << 1) | carry;
+        uint64_t starts = token_bytes & ~previous_token_bytes;
+        uint64_t ends = delim_mask & previous_token_bytes;
+        carry = token_bytes >> (window_size - 1);
+
+        while (count < tokens.size()) {
+            if (!in_token) {
+                if (starts == 0) {
+                    break;
+                }
+                token_begin = window + std::countr_zero(starts);
+                starts &= starts - 1;
+                in_token = true;
+            }
+            if (ends == 0) {
+                break;
+            }
+            tokens[count] = std::span<const char> { token_begin, window + std::countr_zero(ends) };
+            ends &= ends - 1;
+            ++count;
+            in_token = false;
+        }
+    }
+#else
+    while (count < tokens.size()) {
+        token_begin = findFirstOf<false>(first, last, delims);
+        if (token_begin == last) {
+            break;
+        }
+        first = findFirstOf<true>(token_begin, last, delims);
+        tokens[count] = std::span<const char> { token_begin, first };
+        ++count;
+    }
+#endif
+    if (in_token && count < tokens.size()) {
+        tokens[count] = std::span<const char> { token_begin, last };
+        ++count;
+    }
+    return count;
+}
+
+}
@@ -1,16 +1,41 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <compare>
+#include <memory>
 #include <ranges>
 #include <span>
 #include <tuple>
 #include <vector>
 
 #include "wm/Functors.hpp"
+#include "wm/Scanners.hpp"
 
 namespace wm {
 
+namespace detail {
+    // Finds the first element of [first, last) that is (MatchDelims) or isn't (!MatchDelims) one of the delimiters.
+    // Byte ranges go through the vectorised scanner, everything else falls back to std::find_if.
+    template <bool MatchDelims, typename Iterator, typename Element, size_t N>
+    WM_FORCE_INLINE auto findFirstOf(Iterator first, Iterator last, const std::array<Element, N>& delims) -> Iterator
+    {
+        using ValueType = std::remove_cvref_t<decltype(*first)>;
+        if constexpr (std::is_same_v<ValueType, char> && std::is_convertible_v<Element, char>) {
+            std::array<char, N> char_delims;
+            std::ranges::copy(delims, char_delims.begin());
+            const char* begin = std::to_address(first);
+            const char* found = scan::findFirstOf<MatchDelims>(begin, begin + (last - first), char_delims);
+            return first + (found - begin);
+        }
+        else {
+            return std::find_if(first, last, [&](const auto& value) {
+                return std::ranges::find(delims, value) != delims.end() ? MatchDelims : !MatchDelims;
+            });
+        }
+    }
+}
+
 template <std::ranges::contiguous_range Container, typename Element>
 class SplitByElement {
     Container& _container;
@@ -41,8 +66,8 @@ public:
             , container_end(ce)
             , delim(d)
         {
-            sub_begin = std::find_if(sub_begin, container_end, IsNotEqualTo(d));
-            sub_end = std::find_if(sub_begin, container_end, IsEqualTo(d));
+            sub_begin = detail::findFirstOf<false>(sub_begin, container_end, std::array { d });
+            sub_end = detail::findFirstOf<true>(sub_begin, container_end, std::array { d });
         }
 
         auto operator*()
@@ -58,9 +83,9 @@ public:
             }
 
             ++sub_end;
-            sub_end = std::find_if(sub_end, container_end, IsNotEqualTo(delim));
+            sub_end = detail::findFirstOf<false>(sub_end, container_end, std::array { delim });
             sub_begin = sub_end;
-            sub_end = std::find_if(sub_end, container_end, IsEqualTo(delim));
+            sub_end = detail::findFirstOf<true>(sub_end, container_end, std::array { delim });
             return *this;
         }
 
@@ -107,4 +132,106 @@ public:
     }
 };
 
+// Splits on any of several delimiters in a single pass, e.g. an obj face line
+// "f 1/2/3 4/5/6 7/8/9" split by { ' ', '/' } yields "f", "1", "2", "3", ... "9".
+template <std::ranges::contiguous_range Container, typename Element, size_t N>
+class SplitByElements {
+    Container& _container;
+    std::array<Element, N> _delims;
+
+    using ContainerElement = std::remove_reference_t<decltype(*_container.begin())>;
+    using ContainerIterator = std::ranges::iterator_t<Container>;
+
+public:
+    SplitByElements(Container& container, std::array<Element, N> delims)
+        : _container(container)
+        , _delims(delims)
+    {
+        static_assert(std::is_convertible_v<std::remove_cvref_t<Element>, ContainerElement>);
+    }
+
+    struct Iterator {
+        ContainerIterator sub_begin;
+        ContainerIterator sub_end;
+        ContainerIterator container_end;
+        std::array<Element, N> delims;
+
+        Iterator(ContainerIterator sb, ContainerIterator se, ContainerIterator ce, const std::array<Element, N>& d)
+            : sub_begin(sb)
+            , sub_end(se)
+            , container_end(ce)
+            , delims(d)
+        {
+            sub_begin = detail::findFirstOf<false>(sub_begin, container_end, delims);
+            sub_end = detail::findFirstOf<true>(sub_begin, container_end, delims);
+        }
+
+        auto operator*()
+        {
+            return std::span<ContainerElement> { sub_begin, sub_end };
+        }
+
+        auto operator++() -> Iterator&
+        {
+            if (sub_end == container_end) {
+                sub_begin = container_end;
+                return *this;
+            }
+
+            ++sub_end;
+            sub_end = detail::findFirstOf<false>(sub_end, container_end, delims);
+            sub_begin = sub_end;
+            sub_end = detail::findFirstOf<true>(sub_end, container_end, delims);
+            return *this;
+        }
+
+        auto operator==(const Iterator& other) const -> bool
+        {
+            return sub_begin == other.sub_begin
+                && sub_end == other.sub_end
+                && container_end == other.container_end
+                && delims == other.delims;
+        }
+        auto operator!=(const Iterator other) const -> bool
+        {
+            return !(*this == other);
+        }
+    };
+
+    auto begin() const
+    {
+        return Iterator(_container.begin(), _container.begin(), _container.end(), _delims);
+    }
+    auto end() const
+    {
+        return Iterator(_container.end(), _container.end(), _container.end(), _delims);
+    }
+
+    // Writes up to tokens.size() tokens without allocating, returns how many were written.
+    auto evaluateInto(std::span<std::span<ContainerElement>> tokens) const -> size_t
+    {
+        if constexpr (std::is_same_v<ContainerElement, const char> && std::is_convertible_v<Element, char>) {
+            std::array<char, N> char_delims;
+            std::ranges::copy(_delims, char_delims.begin());
+            const char* first = std::to_address(_container.begin());
+            return scan::tokenize(first, first + std::ranges::size(_container), char_delims, tokens);
+        }
+        size_t count = 0;
+        for (auto it = begin(); count < tokens.size() && it != end(); ++it) {
+            tokens[count] = *it;
+            ++count;
+        }
+        return count;
+    }
+
+    auto evaluate() const -> std::vector<std::span<ContainerElement>>
+    {
+        std::vector<std::span<ContainerElement>> tokens;
+        for (auto sub : *this) {
+            tokens.emplace_back(sub);
+        }
+        return tokens;
+    }
+};
+
 }
\ No newline at end of file
@@ -63,6 +63,7 @@ auto Application::init() noexcept -> Expected<void, std::string_view>
 
     m_renderer.init();
     m_input.init(&m_main_context);
+    FrameStream::init();
     ScreenFrameBuffer::init();
 
     return {};
@@ -106,6 +107,8 @@ auto Application::run() noexcept -> Expected<void, std::string_view>
         float dt = elapsed_seconds.count();
         last_time = current_time;
 
+        FrameStream::beginFrame();
+
 #if BUILD_TARGET == WEB_BUILD
         float width = 800;
         float height = 800;
@@ -126,6 +129,9 @@ auto Application::run() noexcept -> Expected<void, std::string_view>
             light_depth_fb_ptr->init(width, height);
         }
 
+        // the passes below all draw what this extracts.
+        renderer_ptr->extract(*scene_ptr);
+
         // render standard objects.
         {
             offscreen_fb_ptr->clearBuffer();
@@ -135,7 +141,7 @@ auto Application::run() noexcept -> Expected<void, std::string_view>
         // render depth buffer
         {
             depth_fb_ptr->clearBuffer();
-            renderer_ptr->draw(*scene_ptr, (float)width, (float)height);
+            renderer_ptr->drawDepth(*scene_ptr, (float)width, (float)height);
         }
 
         // render light shadows
@@ -177,6 +183,23 @@ auto Application::run() noexcept -> Expected<void, std::string_view>
 
             main_context_ptr->swapBuffers();
         }
+        FrameStream::endFrame();
+
+        // how much of the redundant state setting GlState catches, summed over a few seconds of frames.
+        if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+            static auto stats_timer = current_time;
+            static uint64_t stats_frames = 0;
+            ++stats_frames;
+            if (current_time - stats_timer >= std::chrono::seconds(5)) {
+                const GlState::Stats& stats = GlState::getStats();
+                std::cout
+                    << "GL state: " << stats.issued / stats_frames << " calls issued, "
+                    << stats.skipped / stats_frames << " skipped per frame over " << stats_frames << " frames.\n";
+                GlState::resetStats();
+                stats_timer = current_time;
+                stats_frames = 0;
+            }
+        }
 
         scene_ptr->update(dt, *input_ptr);
 
@@ -267,6 +290,7 @@ auto Application::run() noexcept -> Expected<void, std::string_view>
 void Application::stop() noexcept
 {
     ScreenFrameBuffer::stop();
+    FrameStream::stop();
     m_main_context.stop();
     glfwTerminate();
 }
@@ -0,0 +1,126 @@
+#include "CacheFile.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace {
+	template <typename T>
+	auto readAt(const char* p) -> T
+	{
+		T value;
+		std::memcpy(&value, p, sizeof(T));
+		return value;
+	}
+}
+
+namespace CacheFile {
+	auto hashContent(std::span<const char> content) noexcept -> uint64_t
+	{
+		constexpr uint64_t prime_1 = 0x9E3779B185EBCA87ull;
+		constexpr uint64_t prime_2 = 0xC2B2AE3D27D4EB4Full;
+		constexpr uint64_t prime_3 = 0x165667B19E3779F9ull;
+		constexpr uint64_t prime_4 = 0x85EBCA77C2B2AE63ull;
+		constexpr uint64_t prime_5 = 0x27D4EB2F165667C5ull;
+
+		auto round = [](uint64_t acc, uint64_t input) {
+			acc += input * prime_2;
+			acc = std::rotl(acc, 31);
+			return acc * prime_1;
+		};
+		auto merge = [&](uint64_t acc, uint64_t lane) {
+			acc ^= round(0, lane);
+			return acc * prime_1 + prime_4;
+		};
+
+		const char* p = content.data();
+		const char* end = content.data() + content.size();
+		uint64_t hash;
+
+		if (content.size() >= 32) {
+			uint64_t lanes[4] = { prime_1 + prime_2, prime_2, 0, 0 - prime_1 };
+			for (; end - p >= 32; p += 32) {
+				for (size_t i = 0; i < 4; ++i) {
+					lanes[i] = round(lanes[i], readAt<uint64_t>(p + i * 8));
+				}
+			}
+			hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+			for (uint64_t lane : lanes) {
+				hash = merge(hash, lane);
+			}
+		}
+		else {
+			hash = prime_5;
+		}
+		hash += content.size();
+
+		for (; end - p >= 8; p += 8) {
+			hash ^= round(0, readAt<uint64_t>(p));
+			hash = std::rotl(hash, 27) * prime_1 + prime_4;
+		}
+		if (end - p >= 4) {
+			hash ^= readAt<uint32_t>(p) * prime_1;
+			hash = std::rotl(hash, 23) * prime_2 + prime_3;
+			p += 4;
+		}
+		for (; p != end; ++p) {
+			hash ^= static_cast<uint8_t>(*p) * prime_5;
+			hash = std::rotl(hash, 11) * prime_1;
+		}
+
+		hash ^= hash >> 33;
+		hash *= prime_2;
+		hash ^= hash >> 29;
+		hash *= prime_3;
+		hash ^= hash >> 32;
+		return hash;
+	}
+
+	auto temporaryPath(const std::filesystem::path& path) -> std::filesystem::path
+	{
+		// the thread and counter keep writers in this process apart, the random part keeps processes apart.
+		static const uint64_t process_salt = (uint64_t{ std::random_device{}() } << 32) | std::random_device{}();
+		static std::atomic<uint64_t> call_count = 0;
+		const uint64_t thread_hash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+		std::filesystem::path temporary_path = path;
+		temporary_path += "." + std::to_string(process_salt ^ thread_hash) + "-" + std::to_string(call_count++) + ".tmp";
+		return temporary_path;
+	}
+
+	auto write(const std::filesystem::path& path, const std::function<void(std::ostream&)>& writeContent) noexcept -> Expected<void, std::string_view>
+	{
+		std::error_code error;
+		if (path.has_parent_path()) {
+			std::filesystem::create_directories(path.parent_path(), error);
+			if (error) {
+				return { "Failed to create the cache directory." };
+			}
+		}
+
+		const std::filesystem::path temporary_path = temporaryPath(path);
+		{
+			std::ofstream outfile(temporary_path, std::ios::binary | std::ios::trunc);
+			if (!outfile.is_open()) {
+				return { "Failed to open the cache file for writing." };
+			}
+			writeContent(outfile);
+			if (!outfile.good()) {
+				outfile.close();
+				std::filesystem::remove(temporary_path, error);
+				return { "Failed to write the cache file." };
+			}
+		}
+
+		std::filesystem::rename(temporary_path, path, error);
+		if (error) {
+			std::filesystem::remove(temporary_path, error);
+			return { "Failed to move the cache file into place." };
+		}
+		return {};
+	}
+}
@@ -0,0 +1,156 @@
+#include "MappedFile.hpp"
+
+#if BUILD_TARGET == NATIVE_BUILD
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#elif BUILD_TARGET == WEB_BUILD
+#include <fstream>
+#endif
+
+auto MappedFile::init(const std::filesystem::path& path) noexcept -> Expected<void, std::string_view>
+{
+	stop();
+
+#if BUILD_TARGET == NATIVE_BUILD
+#if defined(_WIN32)
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return { "Failed to open the file. Probably in use." };
+	}
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size)) {
+		CloseHandle(file);
+		return { "Failed to query the file size." };
+	}
+	m_file_handle = file;
+	if (file_size.QuadPart == 0) {
+		// a zero length file cannot be mapped, it is just empty content.
+		return {};
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+	if (mapping == nullptr) {
+		stop();
+		return { "Failed to create a file mapping." };
+	}
+	m_mapping_handle = mapping;
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	if (view == nullptr) {
+		stop();
+		return { "Failed to map a view of the file." };
+	}
+	m_data = static_cast<const char*>(view);
+	m_size = static_cast<size_t>(file_size.QuadPart);
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1) {
+		return { "Failed to open the file. Probably in use." };
+	}
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) == -1) {
+		close(fd);
+		return { "Failed to query the file size." };
+	}
+	if (file_stat.st_size == 0) {
+		// a zero length file cannot be mapped, it is just empty content.
+		close(fd);
+		return {};
+	}
+
+	void* view = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	// the mapping keeps its own reference to the file.
+	close(fd);
+	if (view == MAP_FAILED) {
+		return { "Failed to memory map the file." };
+	}
+	// the parser only walks forward through the file.
+	madvise(view, static_cast<size_t>(file_stat.st_size), MADV_SEQUENTIAL);
+
+	m_data = static_cast<const char*>(view);
+	m_size = static_cast<size_t>(file_stat.st_size);
+#endif
+#elif BUILD_TARGET == WEB_BUILD
+	std::ifstream infile(path, std::ios::binary);
+	if (!infile.is_open()) {
+		return { "Failed to open the file. Probably in use." };
+	}
+
+	// preallocate the string size and load all contents.
+	infile.seekg(0, std::ios::end);
+	size_t file_size = infile.tellg();
+	infile.seekg(0, std::ios::beg);
+	m_buffer.resize(file_size);
+	infile.read(m_buffer.data(), file_size);
+#endif
+	return {};
+}
+
+auto MappedFile::stop() noexcept -> void
+{
+#if BUILD_TARGET == NATIVE_BUILD
+#if defined(_WIN32)
+	if (m_data) {
+		UnmapViewOfFile(m_data);
+	}
+	if (m_mapping_handle) {
+		CloseHandle(m_mapping_handle);
+	}
+	if (m_file_handle) {
+		CloseHandle(m_file_handle);
+	}
+	m_mapping_handle = nullptr;
+	m_file_handle = nullptr;
+#else
+	if (m_data) {
+		munmap(const_cast<char*>(m_data), m_size);
+	}
+#endif
+	m_data = nullptr;
+	m_size = 0;
+#elif BUILD_TARGET == WEB_BUILD
+	m_buffer.clear();
+	m_buffer.shrink_to_fit();
+#endif
+}
+
+auto MappedFile::getContent() const noexcept -> std::span<const char>
+{
+#if BUILD_TARGET == NATIVE_BUILD
+	return { m_data, m_size };
+#elif BUILD_TARGET == WEB_BUILD
+	return { m_buffer.data(), m_buffer.size() };
+#endif
+}
+
+auto MappedFile::release(std::span<const char> consumed) const noexcept -> void
+{
+#if BUILD_TARGET == NATIVE_BUILD && !defined(_WIN32)
+	if (!m_data || consumed.empty()) {
+		return;
+	}
+	// only whole pages can be dropped, the partial ones at either end may still be in use by a neighbouring range.
+	static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	size_t begin = static_cast<size_t>(consumed.data() - m_data);
+	size_t end = begin + consumed.size();
+	begin = ((begin + page_size - 1) / page_size) * page_size;
+	end = (end == m_size) ? end : (end / page_size) * page_size;
+	if (begin < end) {
+		// the pages are clean private file pages, so they are simply re-read from the file if touched again.
+		madvise(const_cast<char*>(m_data) + begin, end - begin, MADV_DONTNEED);
+	}
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+	stop();
+}
@@ -0,0 +1,43 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+auto ThreadPool::init(size_t worker_count) -> void
+{
+	stop();
+#if BUILD_TARGET == NATIVE_BUILD
+	if (worker_count == 0) {
+		worker_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+	}
+	m_is_stopping = false;
+	m_workers.reserve(worker_count);
+	for (size_t i = 0; i < worker_count; ++i) {
+		m_workers.emplace_back([this]() {
+			while (true) {
+				std::function<void()> job;
+				{
+					std::unique_lock lock(m_mutex);
+					m_has_jobs.wait(lock, [this]() { return m_is_stopping || !m_jobs.empty(); });
+					if (m_jobs.empty()) {
+						return;
+					}
+					job = std::move(m_jobs.front());
+					m_jobs.pop_front();
+				}
+				job();
+			}
+		});
+	}
+#endif
+}
+
+auto ThreadPool::stop() -> void
+{
+	{
+		std::scoped_lock lock(m_mutex);
+		m_is_stopping = true;
+	}
+	m_has_jobs.notify_all();
+	// jthreads join as they are destroyed.
+	m_workers.clear();
+}
@@ -0,0 +1,285 @@
+#include "renderer/3d/BakedMesh.hpp"
+#include "CacheFile.hpp"
+#include "MappedFile.hpp"
+
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <string>
+
+static_assert(std::endian::native == std::endian::little, "Baked meshes are stored little endian.");
+
+namespace {
+	struct AttributeLayout {
+		uint32_t count;
+		std::array<uint32_t, 4> sizes;
+	};
+
+	constexpr auto attributeLayoutOf(MeshType type) -> AttributeLayout
+	{
+		switch (type) {
+		case MeshType::positions_only:
+			return { 1, { 3, 0, 0, 0 } };
+		case MeshType::positions_and_normals:
+			return { 2, { 3, 3, 0, 0 } };
+		case MeshType::positions_normals_uvs:
+			return { 3, { 3, 3, 2, 0 } };
+		}
+		return { 0, {} };
+	}
+
+	constexpr auto alignUp(uint64_t offset, uint64_t alignment) -> uint64_t
+	{
+		return (offset + alignment - 1) / alignment * alignment;
+	}
+
+	template <typename T>
+	auto readAt(std::span<const char> content, uint64_t offset) -> T
+	{
+		T value;
+		std::memcpy(&value, content.data() + offset, sizeof(T));
+		return value;
+	}
+
+	// copies count elements from offset into out, after checking the range lies within the file.
+	template <typename T>
+	auto copyArray(std::span<const char> content, uint64_t offset, uint64_t count, std::vector<T>& out) -> bool
+	{
+		if (offset > content.size() || count > (content.size() - offset) / sizeof(T)) {
+			return false;
+		}
+		out.resize(count);
+		std::memcpy(out.data(), content.data() + offset, count * sizeof(T));
+		return true;
+	}
+
+	template <MeshType type>
+	auto readMesh(const BakedMesh::MeshRecord& record, std::span<const char> content) -> Expected<MeshVariant, std::string_view>
+	{
+		Mesh<type> mesh;
+		mesh.num_faces = record.num_faces;
+		if (record.vertex_float_count % Mesh<type>::floats_per_vertex_attribute != 0) {
+			return { "The baked mesh's vertex data is not a whole number of vertices." };
+		}
+		if (!copyArray(content, record.vertex_offset, record.vertex_float_count, mesh.vertex_buffer_data)) {
+			return { "The baked mesh's vertex data lies outside of the file." };
+		}
+		if constexpr (requires { mesh.index_buffer_data; }) {
+			if (!copyArray(content, record.index_offset, record.index_count, mesh.index_buffer_data)) {
+				return { "The baked mesh's index data lies outside of the file." };
+			}
+		}
+		else if (record.index_count != 0) {
+			return { "The baked mesh has indices its mesh type cannot hold." };
+		}
+		if constexpr (requires { mesh.lods; }) {
+			if (!copyArray(content, record.lod_offset, record.lod_count, mesh.lods)) {
+				return { "The baked mesh's levels of detail lie outside of the file." };
+			}
+			if (!copyArray(content, record.meshlet_offset, record.meshlet_count, mesh.meshlets)) {
+				return { "The baked mesh's meshlets lie outside of the file." };
+			}
+			for (const MeshLod& lod : mesh.lods) {
+				if (lod.index_offset > mesh.index_buffer_data.size() || lod.index_count > mesh.index_buffer_data.size() - lod.index_offset) {
+					return { "The baked mesh's levels of detail lie outside of its indices." };
+				}
+				if (lod.meshlet_offset > mesh.meshlets.size() || lod.meshlet_count > mesh.meshlets.size() - lod.meshlet_offset) {
+					return { "The baked mesh's levels of detail lie outside of its meshlets." };
+				}
+			}
+			for (const Meshlet& meshlet : mesh.meshlets) {
+				if (meshlet.index_offset > mesh.index_buffer_data.size() || meshlet.index_count > mesh.index_buffer_data.size() - meshlet.index_offset) {
+					return { "The baked mesh's meshlets lie outside of its indices." };
+				}
+			}
+		}
+		else if (record.lod_count != 0 || record.meshlet_count != 0) {
+			return { "The baked mesh has levels of detail its mesh type cannot hold." };
+		}
+		if constexpr (requires { mesh.bounds_min; }) {
+			mesh.bounds_min = { record.bounds_min[0], record.bounds_min[1], record.bounds_min[2] };
+			mesh.bounds_max = { record.bounds_max[0], record.bounds_max[1], record.bounds_max[2] };
+		}
+		return MeshVariant{ std::move(mesh) };
+	}
+}
+
+namespace BakedMesh {
+	auto cachePath(const std::filesystem::path& cache_dir, uint64_t source_hash) -> std::filesystem::path
+	{
+		constexpr std::string_view hex_digits = "0123456789abcdef";
+		std::string file_name(16, '0');
+		for (size_t i = 0; i < file_name.size(); ++i) {
+			file_name[file_name.size() - 1 - i] = hex_digits[(source_hash >> (i * 4)) & 0xF];
+		}
+		file_name += extension;
+		return cache_dir / file_name;
+	}
+
+	auto read(const std::filesystem::path& path, uint64_t source_hash) noexcept -> Expected<std::vector<MeshVariant>, std::string_view>
+	{
+		MappedFile baked_file;
+		if (auto result = baked_file.init(path); result.HasError()) {
+			return { result.Error() };
+		}
+		std::span<const char> content = baked_file.getContent();
+
+		if (content.size() < sizeof(FileHeader)) {
+			return { "The baked mesh file is truncated." };
+		}
+		auto header = readAt<FileHeader>(content, 0);
+		if (header.magic != magic) {
+			return { "The file is not a baked mesh." };
+		}
+		if (header.version != version) {
+			return { "The baked mesh is from another version." };
+		}
+		if (header.source_hash != source_hash) {
+			return { "The baked mesh was made from different content." };
+		}
+		if (header.mesh_count > (content.size() - sizeof(FileHeader)) / sizeof(MeshRecord)) {
+			return { "The baked mesh file is truncated." };
+		}
+
+		std::vector<MeshVariant> meshes;
+		meshes.reserve(header.mesh_count);
+		for (uint32_t i = 0; i < header.mesh_count; ++i) {
+			auto record = readAt<MeshRecord>(content, sizeof(FileHeader) + i * sizeof(MeshRecord));
+
+			const auto type = static_cast<MeshType>(record.mesh_type);
+			const AttributeLayout expected_layout = attributeLayoutOf(type);
+			if (expected_layout.count == 0 || record.attribute_count != expected_layout.count || record.attribute_sizes != expected_layout.sizes) {
+				return { "The baked mesh's attribute layout is not supported." };
+			}
+
+			Expected<MeshVariant, std::string_view> mesh;
+			switch (type) {
+			case MeshType::positions_only:
+				mesh = readMesh<MeshType::positions_only>(record, content);
+				break;
+			case MeshType::positions_and_normals:
+				mesh = readMesh<MeshType::positions_and_normals>(record, content);
+				break;
+			case MeshType::positions_normals_uvs:
+				mesh = readMesh<MeshType::positions_normals_uvs>(record, content);
+				break;
+			}
+			if (mesh.HasError()) {
+				return { mesh.Error() };
+			}
+			meshes.emplace_back(std::move(mesh.Value()));
+		}
+		return meshes;
+	}
+
+	auto write(const std::filesystem::path& path, uint64_t source_hash, const std::vector<MeshVariant>& meshes) noexcept -> Expected<void, std::string_view>
+	{
+		if (meshes.size() > std::numeric_limits<uint32_t>::max()) {
+			return { "Too many meshes to bake into one file." };
+		}
+		FileHeader header = {
+			.magic = magic,
+			.version = version,
+			.source_hash = source_hash,
+			.mesh_count = static_cast<uint32_t>(meshes.size()),
+			.reserved = 0
+		};
+
+		// lay out every array after the header and records before writing anything.
+		std::vector<MeshRecord> records;
+		records.reserve(meshes.size());
+		uint64_t offset = sizeof(FileHeader) + meshes.size() * sizeof(MeshRecord);
+		for (const MeshVariant& mesh_variant : meshes) {
+			std::visit([&]<MeshType type>(const Mesh<type>& mesh) {
+				const AttributeLayout layout = attributeLayoutOf(type);
+				MeshRecord& record = records.emplace_back(MeshRecord{
+					.mesh_type = static_cast<uint32_t>(type),
+					.attribute_count = layout.count,
+					.attribute_sizes = layout.sizes,
+					.num_faces = mesh.num_faces,
+					.vertex_offset = 0,
+					.vertex_float_count = mesh.vertex_buffer_data.size(),
+					.index_offset = 0,
+					.index_count = 0,
+					.lod_offset = 0,
+					.lod_count = 0,
+					.meshlet_offset = 0,
+					.meshlet_count = 0,
+					.bounds_min = {},
+					.bounds_max = {} });
+
+				offset = alignUp(offset, data_alignment);
+				record.vertex_offset = offset;
+				offset += mesh.vertex_buffer_data.size() * sizeof(float);
+				offset = alignUp(offset, data_alignment);
+				record.index_offset = offset;
+				if constexpr (requires { mesh.index_buffer_data; }) {
+					record.index_count = mesh.index_buffer_data.size();
+					offset += mesh.index_buffer_data.size() * sizeof(uint32_t);
+				}
+				offset = alignUp(offset, data_alignment);
+				record.lod_offset = offset;
+				if constexpr (requires { mesh.lods; }) {
+					record.lod_count = mesh.lods.size();
+					offset += mesh.lods.size() * sizeof(MeshLod);
+				}
+				offset = alignUp(offset, data_alignment);
+				record.meshlet_offset = offset;
+				if constexpr (requires { mesh.meshlets; }) {
+					record.meshlet_count = mesh.meshlets.size();
+					offset += mesh.meshlets.size() * sizeof(Meshlet);
+				}
+
+				if constexpr (requires { mesh.bounds_min; }) {
+					record.bounds_min = { mesh.bounds_min.x, mesh.bounds_min.y, mesh.bounds_min.z };
+					record.bounds_max = { mesh.bounds_max.x, mesh.bounds_max.y, mesh.bounds_max.z };
+				}
+				else if (!mesh.vertex_buffer_data.empty()) {
+					constexpr size_t stride = Mesh<type>::floats_per_vertex_attribute;
+					record.bounds_min = { mesh.vertex_buffer_data[0], mesh.vertex_buffer_data[1], mesh.vertex_buffer_data[2] };
+					record.bounds_max = record.bounds_min;
+					for (size_t i = 0; i + stride <= mesh.vertex_buffer_data.size(); i += stride) {
+						for (size_t axis = 0; axis < 3; ++axis) {
+							record.bounds_min[axis] = std::min(record.bounds_min[axis], mesh.vertex_buffer_data[i + axis]);
+							record.bounds_max[axis] = std::max(record.bounds_max[axis], mesh.vertex_buffer_data[i + axis]);
+						}
+					}
+				}
+			}, mesh_variant);
+		}
+
+		return CacheFile::write(path, [&](std::ostream& outfile) {
+			uint64_t written = 0;
+			auto writeBytes = [&](const void* data, uint64_t size) {
+				outfile.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+				written += size;
+			};
+			auto padTo = [&](uint64_t target) {
+				constexpr std::array<char, data_alignment> zeros{};
+				writeBytes(zeros.data(), target - written);
+			};
+
+			writeBytes(&header, sizeof(header));
+			writeBytes(records.data(), records.size() * sizeof(MeshRecord));
+			for (size_t i = 0; i < meshes.size(); ++i) {
+				std::visit([&](const auto& mesh) {
+					padTo(records[i].vertex_offset);
+					writeBytes(mesh.vertex_buffer_data.data(), mesh.vertex_buffer_data.size() * sizeof(float));
+					padTo(records[i].index_offset);
+					if constexpr (requires { mesh.index_buffer_data; }) {
+						writeBytes(mesh.index_buffer_data.data(), mesh.index_buffer_data.size() * sizeof(uint32_t));
+					}
+					padTo(records[i].lod_offset);
+					if constexpr (requires { mesh.lods; }) {
+						writeBytes(mesh.lods.data(), mesh.lods.size() * sizeof(MeshLod));
+					}
+					padTo(records[i].meshlet_offset);
+					if constexpr (requires { mesh.meshlets; }) {
+						writeBytes(mesh.meshlets.data(), mesh.meshlets.size() * sizeof(Meshlet));
+					}
+				}, meshes[i]);
+			}
+		});
+	}
+}
@@ -0,0 +1,235 @@
+#include "renderer/3d/GeometryArena.hpp"
+
+#include <algorithm>
+#include <optional>
+
+namespace {
+	// the smallest doubling of capacity that holds needed, capacity itself if it already does.
+	auto grownCapacity(uint32_t capacity, uint64_t needed) -> uint32_t
+	{
+		uint64_t grown = std::max<uint64_t>(capacity, 1);
+		while (grown < needed) {
+			grown *= 2;
+		}
+		return static_cast<uint32_t>(grown);
+	}
+}
+
+template <MeshType mesh_type>
+void GeometryArena<mesh_type>::init()
+{
+	stop();
+	m_va.init();
+	m_position_va.init();
+	m_vertex_allocator.init(0);
+	m_index_allocator.init(0);
+	m_is_init = true;
+	repack(initial_vertex_capacity, initial_index_capacity);
+}
+
+template <MeshType mesh_type>
+void GeometryArena<mesh_type>::stop()
+{
+	if (!m_is_init) {
+		return;
+	}
+	m_position_va.stop();
+	m_va.stop();
+	m_ib.stop();
+	m_attribute_vb.stop();
+	m_position_vb.stop();
+	m_entries.clear();
+	m_free_handles.clear();
+	m_is_init = false;
+}
+
+template <MeshType mesh_type>
+void GeometryArena<mesh_type>::bind(VertexBuffer& instance_vb, size_t offset_in_bytes)
+{
+	// attaching binds the vertex array, and the instances move with every draw anyway.
+	auto instance_layout = getInstanceLayout();
+	m_va.attachBufferAndLayout(instance_vb, instance_layout, instance_matrix_location, offset_in_bytes, 1);
+}
+
+template <MeshType mesh_type>
+void GeometryArena<mesh_type>::bindPositions(VertexBuffer& instance_vb, size_t offset_in_bytes)
+{
+	auto instance_layout = getInstanceLayout();
+	m_position_va.attachBufferAndLayout(instance_vb, instance_layout, instance_matrix_location, offset_in_bytes, 1);
+}
+
+template <MeshType mesh_type>
+void GeometryArena<mesh_type>::unbind()
+{
+	m_va.unbind();
+}
+
+template <MeshType mesh_type>
+auto GeometryArena<mesh_type>::add(std::span<const std::byte> position_bytes, std::span<const std::byte> attribute_bytes, std::span<const uint32_t> indices) -> Handle
+{
+	if (!m_is_init) {
+		init();
+	}
+	const uint32_t position_stride = getPositionLayout().stride;
+	const uint32_t attribute_stride = getAttributeLayout().stride;
+	const auto vertex_count = static_cast<uint32_t>(position_bytes.size() / position_stride);
+	const auto index_count = static_cast<uint32_t>(indices.size());
+
+	std::optional<BufferAllocator::Range> vertices = m_vertex_allocator.allocate(vertex_count);
+	std::optional<BufferAllocator::Range> index_range = m_index_allocator.allocate(index_count);
+	if (!vertices || !index_range) {
+		if (vertices) {
+			m_vertex_allocator.free(vertices.value());
+		}
+		if (index_range) {
+			m_index_allocator.free(index_range.value());
+		}
+		// repacking at the same capacity is enough when the room is only there in pieces.
+		const uint64_t vertices_needed = uint64_t{ m_vertex_allocator.getCapacity() } - m_vertex_allocator.getFreeSize() + vertex_count;
+		const uint64_t indices_needed = uint64_t{ m_index_allocator.getCapacity() } - m_index_allocator.getFreeSize() + index_count;
+		repack(grownCapacity(m_vertex_allocator.getCapacity(), vertices_needed), grownCapacity(m_index_allocator.getCapacity(), indices_needed));
+		vertices = m_vertex_allocator.allocate(vertex_count);
+		index_range = m_index_allocator.allocate(index_count);
+	}
+
+	// loading the indices binds the index buffer, which must not land in whichever vertex array is bound.
+	m_va.unbind();
+	m_position_vb.loadSubVertices(size_t{ vertices->offset } * position_stride, position_bytes);
+	if constexpr (hasNormals(mesh_type)) {
+		m_attribute_vb.loadSubVertices(size_t{ vertices->offset } * attribute_stride, attribute_bytes);
+	}
+
+	Entry entry = { .vertices = vertices.value(), .indices = index_range.value(), .is_live = true };
+#if BUILD_TARGET == NATIVE_BUILD
+	m_ib.loadSubIndices(index_range->offset, indices);
+#elif BUILD_TARGET == WEB_BUILD
+	entry.original_indices.assign(indices.begin(), indices.end());
+	std::vector<uint32_t> offset_indices(indices.size());
+	std::ranges::transform(indices, offset_indices.begin(), [&](uint32_t index) { return index + vertices->offset; });
+	m_ib.loadSubIndices(index_range->offset, offset_indices);
+#endif
+	m_position_vb.unbind();
+	m_ib.unbind();
+
+	if (!m_free_handles.empty()) {
+		const Handle handle = m_free_handles.back();
+		m_free_handles.pop_back();
+		m_entries[handle] = std::move(entry);
+		return handle;
+	}
+	m_entries.emplace_back(std::move(entry));
+	return static_cast<Handle>(m_entries.size() - 1);
+}
+
+template <MeshType mesh_type>
+auto GeometryArena<mesh_type>::remove(Handle handle) -> void
+{
+	if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+		if (handle >= m_entries.size() || !m_entries[handle].is_live) {
+			std::cerr << "GeometryArena failed, trying to \"remove\" a mesh that isn't in the arena.\n";
+			exit(EXIT_FAILURE);
+		}
+	}
+	Entry& entry = m_entries[handle];
+	m_vertex_allocator.free(entry.vertices);
+	m_index_allocator.free(entry.indices);
+	entry = Entry{ .vertices = {}, .indices = {}, .is_live = false };
+	m_free_handles.emplace_back(handle);
+}
+
+template <MeshType mesh_type>
+auto GeometryArena<mesh_type>::compact() -> void
+{
+	if (m_is_init && (m_vertex_allocator.getFreeBlockCount() > 1 || m_index_allocator.getFreeBlockCount() > 1)) {
+		repack(m_vertex_allocator.getCapacity(), m_index_allocator.getCapacity());
+	}
+}
+
+template <MeshType mesh_type>
+auto GeometryArena<mesh_type>::getBaseVertex(Handle handle) const noexcept -> int32_t
+{
+#if BUILD_TARGET == NATIVE_BUILD
+	return static_cast<int32_t>(m_entries[handle].vertices.offset);
+#elif BUILD_TARGET == WEB_BUILD
+	return 0;
+#endif
+}
+
+template <MeshType mesh_type>
+auto GeometryArena<mesh_type>::repack(uint32_t vertex_capacity, uint32_t index_capacity) -> void
+{
+	const uint32_t position_stride = getPositionLayout().stride;
+	const uint32_t attribute_stride = getAttributeLayout().stride;
+
+	// reserving the index buffer binds it, which must not land in whichever vertex array is bound.
+	m_va.unbind();
+
+	VertexBuffer positions;
+	VertexBuffer attributes;
+	IndexBuffer indices;
+	positions.init();
+	positions.reserve(size_t{ vertex_capacity } * position_stride);
+	if constexpr (hasNormals(mesh_type)) {
+		attributes.init();
+		attributes.reserve(size_t{ vertex_capacity } * attribute_stride);
+	}
+	indices.init();
+	indices.reserve(index_capacity);
+
+	// fresh allocators hand out ranges front to back, which packs the live meshes in handle order.
+	m_vertex_allocator.init(vertex_capacity);
+	m_index_allocator.init(index_capacity);
+	for (Entry& entry : m_entries) {
+		if (!entry.is_live) {
+			continue;
+		}
+		const BufferAllocator::Range packed_vertices = m_vertex_allocator.allocate(entry.vertices.size).value();
+		const BufferAllocator::Range packed_indices = m_index_allocator.allocate(entry.indices.size).value();
+
+		positions.copyFrom(m_position_vb, size_t{ entry.vertices.offset } * position_stride, size_t{ packed_vertices.offset } * position_stride, size_t{ entry.vertices.size } * position_stride);
+		if constexpr (hasNormals(mesh_type)) {
+			attributes.copyFrom(m_attribute_vb, size_t{ entry.vertices.offset } * attribute_stride, size_t{ packed_vertices.offset } * attribute_stride, size_t{ entry.vertices.size } * attribute_stride);
+		}
+#if BUILD_TARGET == NATIVE_BUILD
+		indices.copyFrom(m_ib, entry.indices.offset, packed_indices.offset, entry.indices.size);
+#elif BUILD_TARGET == WEB_BUILD
+		// the vertices moved, so the pre offset indices have to be redone rather than copied.
+		std::vector<uint32_t> offset_indices(entry.original_indices.size());
+		std::ranges::transform(entry.original_indices, offset_indices.begin(), [&](uint32_t index) { return index + packed_vertices.offset; });
+		indices.loadSubIndices(packed_indices.offset, offset_indices);
+#endif
+		entry.vertices = packed_vertices;
+		entry.indices = packed_indices;
+	}
+
+	// the locals now hold the old buffers and delete them on the way out.
+	m_position_vb.swap(positions);
+	m_attribute_vb.swap(attributes);
+	m_ib.swap(indices);
+	attachBuffers();
+}
+
+template <MeshType mesh_type>
+auto GeometryArena<mesh_type>::attachBuffers() -> void
+{
+	auto position_layout = getPositionLayout();
+	auto attribute_layout = getAttributeLayout();
+
+	// the element array binding is part of the vao state, so bind the indices while each is bound.
+	m_va.attachBufferAndLayout(m_position_vb, position_layout);
+	if constexpr (hasNormals(mesh_type)) {
+		m_va.attachBufferAndLayout(m_attribute_vb, attribute_layout, static_cast<uint32_t>(position_layout.elements.size()));
+	}
+	m_ib.bind();
+
+	m_position_va.attachBufferAndLayout(m_position_vb, position_layout);
+	m_ib.bind();
+
+	m_position_va.unbind();
+	m_position_vb.unbind();
+	m_ib.unbind();
+}
+
+template class GeometryArena<MeshType::positions_only>;
+template class GeometryArena<MeshType::positions_and_normals>;
+template class GeometryArena<MeshType::positions_normals_uvs>;
@@ -0,0 +1,81 @@
+#include "renderer/3d/GpuMesh.hpp"
+
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace {
+	// Splits the interleaved floats of each vertex into the position stream and the stream of everything else.
+	template <MeshType mesh_type>
+	auto splitStreams(const Mesh<mesh_type>& mesh) -> std::pair<std::vector<float>, std::vector<float>>
+	{
+		constexpr size_t stride = Mesh<mesh_type>::floats_per_vertex_attribute;
+		constexpr size_t floats_per_position = 3;
+		const size_t vertex_count = mesh.vertex_buffer_data.size() / stride;
+
+		std::vector<float> positions;
+		std::vector<float> attributes;
+		positions.reserve(vertex_count * floats_per_position);
+		attributes.reserve(vertex_count * (stride - floats_per_position));
+		for (size_t i = 0; i < vertex_count; ++i) {
+			const float* vertex = mesh.vertex_buffer_data.data() + i * stride;
+			positions.insert(positions.end(), vertex, vertex + floats_per_position);
+			attributes.insert(attributes.end(), vertex + floats_per_position, vertex + stride);
+		}
+		return { std::move(positions), std::move(attributes) };
+	}
+}
+
+template <MeshType mesh_type>
+void GpuMesh<mesh_type>::init(const Mesh<mesh_type>& mesh, GeometryArena<mesh_type>& arena)
+{
+	m_arena = &arena;
+	if constexpr (BuildSettings::quantised_vertices) {
+		QuantisedMesh<mesh_type> quantised = VertexQuantisation::quantise(mesh);
+		m_handle = arena.add(std::as_bytes(std::span{ quantised.positions }), std::as_bytes(std::span{ quantised.attributes }), mesh.index_buffer_data);
+		m_dequantisation = quantised.dequantisation;
+	} else {
+		auto [positions, attributes] = splitStreams(mesh);
+		m_handle = arena.add(std::as_bytes(std::span{ positions }), std::as_bytes(std::span{ attributes }), mesh.index_buffer_data);
+		m_dequantisation = glm::mat4(1.0f);
+	}
+
+	m_lods = mesh.lods;
+	m_meshlets = mesh.meshlets;
+	if (m_lods.empty()) {
+		m_lods.emplace_back(MeshLod{ 0, static_cast<uint32_t>(mesh.index_buffer_data.size()), 0, 0 });
+	}
+	m_bounding_centre = (mesh.bounds_min + mesh.bounds_max) * 0.5f;
+	m_bounding_radius = glm::length(mesh.bounds_max - mesh.bounds_min) * 0.5f;
+}
+
+template <MeshType mesh_type>
+void GpuMesh<mesh_type>::stop()
+{
+	if (m_arena) {
+		m_arena->remove(m_handle);
+		m_arena = nullptr;
+	}
+}
+
+template <MeshType mesh_type>
+void GpuMesh<mesh_type>::bind(VertexBuffer& instance_vb, size_t offset_in_bytes)
+{
+	m_arena->bind(instance_vb, offset_in_bytes);
+}
+
+template <MeshType mesh_type>
+void GpuMesh<mesh_type>::bindPositions(VertexBuffer& instance_vb, size_t offset_in_bytes)
+{
+	m_arena->bindPositions(instance_vb, offset_in_bytes);
+}
+
+template <MeshType mesh_type>
+void GpuMesh<mesh_type>::unbind()
+{
+	m_arena->unbind();
+}
+
+template class GpuMesh<MeshType::positions_only>;
+template class GpuMesh<MeshType::positions_and_normals>;
+template class GpuMesh<MeshType::positions_normals_uvs>;
@@ -0,0 +1,57 @@
+#include "renderer/3d/LodSelection.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <variant>
+#include <numbers>
+
+namespace LodSelection {
+	auto projectedArea(const glm::vec3& centre, float radius, const glm::mat4& model_view, const glm::mat4& projection, float viewport_height) noexcept -> float
+	{
+		const glm::vec4 view_centre = model_view * glm::vec4(centre, 1.0f);
+		// the transforms scale uniformly, any column's length is the scale.
+		const float view_radius = radius * glm::length(glm::vec3(model_view[0]));
+		const float depth = -view_centre.z;
+		if (depth <= view_radius) {
+			return std::numeric_limits<float>::infinity();
+		}
+
+		// projection[1][1] is cot(fov / 2), which maps a view space height at depth 1 to ndc.
+		const float pixel_radius = view_radius / depth * projection[1][1] * viewport_height * 0.5f;
+		return std::numbers::pi_v<float> * pixel_radius * pixel_radius;
+	}
+
+	auto selectLod(std::span<const GpuMeshVariant> meshes, const glm::mat4& model_view, const glm::mat4& projection, float viewport_height) noexcept -> uint32_t
+	{
+		if (meshes.empty()) {
+			return 0;
+		}
+
+		// one sphere around every mesh's sphere.
+		glm::vec3 bounds_min = glm::vec3(std::numeric_limits<float>::max());
+		glm::vec3 bounds_max = glm::vec3(std::numeric_limits<float>::lowest());
+		uint32_t lod_count = 0;
+		for (const auto& mesh : meshes) {
+			std::visit([&](const auto& typed_mesh) {
+				bounds_min = glm::min(bounds_min, typed_mesh.getBoundingCentre() - typed_mesh.getBoundingRadius());
+				bounds_max = glm::max(bounds_max, typed_mesh.getBoundingCentre() + typed_mesh.getBoundingRadius());
+				lod_count = std::max(lod_count, typed_mesh.getLodCount());
+			}, mesh);
+		}
+		const glm::vec3 centre = (bounds_min + bounds_max) * 0.5f;
+		const float radius = glm::length(bounds_max - bounds_min) * 0.5f;
+
+		const float triangle_budget = projectedArea(centre, radius, model_view, projection, viewport_height) * triangles_per_pixel;
+		for (uint32_t lod = 0; lod + 1 < lod_count; ++lod) {
+			uint64_t triangle_count = 0;
+			for (const auto& mesh : meshes) {
+				triangle_count += std::visit([&](const auto& typed_mesh) { return typed_mesh.getLod(lod).index_count / 3; }, mesh);
+			}
+			if (static_cast<float>(triangle_count) <= triangle_budget) {
+				return lod;
+			}
+		}
+		return (lod_count == 0) ? 0 : lod_count - 1;
+	}
+}
@@ -1,27 +1,84 @@
 #include "Libraries.hpp"
 #include "renderer/3d/Mesh.hpp"
+#include "renderer/3d/BakedMesh.hpp"
+#include "renderer/3d/Meshlets.hpp"
+#include "renderer/3d/MeshSimplifier.hpp"
+#include "CacheFile.hpp"
 #include "Concept.hpp"
+#include "MappedFile.hpp"
 
 #include <glm/glm.hpp>
+#include <wm/Parsers.hpp>
 #include <wm/Splitters.hpp>
 
-#include <charconv>
-#include <fstream>
 #include <algorithm>
-#include <iterator>
+#include <array>
+#include <iostream>
+#include <span>
+#include <thread>
+#include <unordered_map>
 #include "Expected.hpp"
 
-template <MeshType type>
-auto loadMeshAs(const std::string& content) -> Expected<std::vector<MeshVariant>, std::string_view>;
-template <>
-auto loadMeshAs<MeshType::positions_only>(const std::string& content)->Expected<std::vector<MeshVariant>, std::string_view>;
-template <>
-auto loadMeshAs<MeshType::positions_and_normals>(const std::string& content)->Expected<std::vector<MeshVariant>, std::string_view>;
-template <>
-auto loadMeshAs<MeshType::positions_normals_uvs>(const std::string& content)->Expected<std::vector<MeshVariant>, std::string_view>;
+// Parses the obj into the richest MeshType every one of its faces has the attributes for.
+static auto loadObj(const MappedFile& obj_file, size_t max_threads) -> Expected<std::vector<MeshVariant>, std::string_view>;
+
+// Splits the level's range of the mesh's indices into meshlets, appending them to the mesh.
+template <typename MeshT>
+static void buildMeshlets(MeshT& mesh, MeshLod& lod)
+{
+	std::span<uint32_t> indices = std::span{ mesh.index_buffer_data }.subspan(lod.index_offset, lod.index_count);
+	auto meshlets = Meshlets::build(indices, mesh.vertex_buffer_data, MeshT::floats_per_vertex_attribute);
+	lod.meshlet_offset = static_cast<uint32_t>(mesh.meshlets.size());
+	lod.meshlet_count = static_cast<uint32_t>(meshlets.size());
+	for (Meshlet& meshlet : meshlets) {
+		meshlet.index_offset += lod.index_offset;
+		mesh.meshlets.emplace_back(meshlet);
+	}
+}
+
+// Reorders every indexed mesh's triangles and vertices for the gpu's caches, then appends its levels of detail.
+// Every level is split into meshlets the renderer can cull.
+static auto optimiseMeshes(std::vector<MeshVariant>& meshes) -> std::vector<MeshLoader::MeshReport>
+{
+	std::vector<MeshLoader::MeshReport> reports;
+	for (MeshVariant& mesh_variant : meshes) {
+		std::visit([&](auto& mesh) {
+			if constexpr (requires { mesh.index_buffer_data; mesh.lods; mesh.meshlets; }) {
+				constexpr size_t stride = std::decay_t<decltype(mesh)>::floats_per_vertex_attribute;
+				const size_t vertex_count = mesh.vertex_buffer_data.size() / stride;
+
+				mesh.lods.clear();
+				mesh.meshlets.clear();
+				MeshLod& full_lod = mesh.lods.emplace_back(MeshLod{ 0, static_cast<uint32_t>(mesh.index_buffer_data.size()), 0, 0 });
+
+				auto& report = reports.emplace_back();
+				report.optimisation.before = MeshOptimiser::analyseVertexCache(mesh.index_buffer_data, vertex_count);
+				MeshOptimiser::optimiseVertexCache(mesh.index_buffer_data, vertex_count);
+				MeshOptimiser::optimiseOverdraw(mesh.index_buffer_data, mesh.vertex_buffer_data, stride);
+				// meshlets regroup the triangles, the vertex order should follow the final triangle order.
+				buildMeshlets(mesh, full_lod);
+				MeshOptimiser::optimiseVertexFetch(mesh.index_buffer_data, mesh.vertex_buffer_data, stride);
+				report.optimisation.after = MeshOptimiser::analyseVertexCache(mesh.index_buffer_data, vertex_count);
+
+				// the coarser levels are built after the vertices are in their final order, so they can share them.
+				auto lod_indices = MeshSimplifier::buildLodChain(mesh.index_buffer_data, mesh.vertex_buffer_data, stride);
+				report.lod_triangle_counts.emplace_back(mesh.index_buffer_data.size() / 3);
+				for (std::vector<uint32_t>& indices : lod_indices) {
+					MeshOptimiser::optimiseVertexCache(indices, vertex_count);
+					MeshLod lod = { static_cast<uint32_t>(mesh.index_buffer_data.size()), static_cast<uint32_t>(indices.size()), 0, 0 };
+					mesh.index_buffer_data.insert(mesh.index_buffer_data.end(), indices.begin(), indices.end());
+					buildMeshlets(mesh, lod);
+					mesh.lods.emplace_back(lod);
+					report.lod_triangle_counts.emplace_back(indices.size() / 3);
+				}
+			}
+		}, mesh_variant);
+	}
+	return reports;
+}
 
 namespace MeshLoader {
-	auto fromObj(std::filesystem::path obj_path) noexcept -> Expected<std::vector<MeshVariant>, std::string_view>
+	auto fromObj(std::filesystem::path obj_path, size_t max_threads) noexcept -> Expected<std::vector<MeshVariant>, std::string_view>
 	{
 #if BUILD_TARGET == NATIVE_BUILD
 		if (!std::filesystem::exists(obj_path)) {
@@ -31,528 +88,378 @@ namespace MeshLoader {
 		if (obj_path.extension() != ".obj") {
 			return { "The file format must be .obj." };
 		}
-		std::ifstream infile(obj_path);
-		if (!infile.is_open()) {
-			return { "Failed to open the file. Probably in use." };
+		MappedFile obj_file;
+		if (auto result = obj_file.init(obj_path); result.HasError()) {
+			return { result.Error() };
 		}
 
-		// preallocate the string size and load all contents.
-		infile.seekg(0, std::ios::end);
-		size_t fileSize = infile.tellg();
-		infile.seekg(0, std::ios::beg);
-		std::string content(fileSize, '\0');
-		infile.read(&content[0], fileSize);
-
-		std::vector<MeshVariant> meshes;
-
-		/*return loadMeshAs<MeshType::positions_normals_uvs>(content)
-			.or_else([&](std::string_view error) {
-			return loadMeshAs<MeshType::positions_and_normals>(content);
-				})
-			.or_else([&](std::string_view error) {
-					return loadMeshAs<MeshType::positions_only>(content);
-				});*/
-
-		return loadMeshAs<MeshType::positions_normals_uvs>(content);
-	}
-}
-
-enum class ObjReadingState {
-	waiting_for_vertices,
-	reading_vertices,
-	waiting_for_normals,
-	reading_normals,
-	waiting_for_uvs,
-	reading_uvs,
-	waiting_for_indices,
-	reading_indices,
-	finished,
-};
-
-static float toFloat(const Concept::IsContiguousRangeWithUnderlyingType<char> auto& num_string)
-{
-	float num = 0.0f;
-#if BUILD_TARGET == WEB_BUILD
-	static std::string tmp;
-	tmp.clear();
-	std::copy(num_string.begin(), num_string.end(), std::back_inserter(tmp));
-	num = std::stof(tmp);
-#else 
-	std::from_chars(
-		num_string.data(), 
-		num_string.data() + num_string.size(), 
-		num,
-		std::chars_format::general
-	);
-#endif
-	return num;
-}
-
-template <>
-auto loadMeshAs<MeshType::positions_only>(const std::string& content) -> Expected<std::vector<MeshVariant>, std::string_view>
-{
-	std::vector<glm::vec3> vertices;
-	
-	vertices.reserve(10000);
-
-	Mesh<MeshType::positions_only> mesh;
-	mesh.num_faces = 0;
-	std::vector<MeshVariant> meshes;
-
-	ObjReadingState state = ObjReadingState::waiting_for_vertices;
-
-	for (const std::span<const char> line : wm::SplitByElement(content, '\n')) {
-		std::span<const char> first_word = *wm::SplitByElement(line, ' ').begin();
-
-		if (state == ObjReadingState::waiting_for_vertices && std::ranges::equal(first_word, std::string_view{ "v" })) {
-			state = ObjReadingState::reading_vertices;
-		}
-		else if (state == ObjReadingState::reading_vertices) {
-			if (std::ranges::equal(first_word, std::string_view{ "v" })) {
-				state = ObjReadingState::reading_vertices;
+		// a baked copy is only trusted when it was made from exactly these bytes.
+		const uint64_t source_hash = CacheFile::hashContent(obj_file.getContent());
+		const std::filesystem::path baked_path = BakedMesh::cachePath(cache_directory, source_hash);
+		std::error_code error;
+		if (std::filesystem::exists(baked_path, error)) {
+			if (auto baked = BakedMesh::read(baked_path, source_hash); baked.HasValue()) {
+				return baked;
 			}
-			else if (std::ranges::equal(first_word, std::string_view{ "f" })) {
-				state = ObjReadingState::reading_indices;
-			}
-			else {
-				state = ObjReadingState::waiting_for_indices;
-			}
-		}
-		else if (state == ObjReadingState::waiting_for_indices && std::ranges::equal(first_word, std::string_view{ "f" })) {
-			state = ObjReadingState::reading_indices;
-		}
-		else if (state == ObjReadingState::reading_indices && !std::ranges::equal(first_word, std::string_view{ "f" })) {
-			state = ObjReadingState::waiting_for_vertices;
-			Mesh<MeshType::positions_only> other_mesh;
-			std::swap(other_mesh, mesh);
-			meshes.emplace_back(std::move(other_mesh));
 		}
 
-		if (state == ObjReadingState::reading_vertices) {
-			glm::vec3 vec3;
-			auto begin = ++(wm::SplitByElement(line, ' ').begin());
-			vec3[0] = toFloat(*begin);
-			++begin;
-			vec3[1] = toFloat(*begin);
-			++begin;
-			vec3[2] = toFloat(*begin);
-			vertices.emplace_back(std::move(vec3));
+		auto meshes = loadObj(obj_file, max_threads);
+		if (meshes.HasValue()) {
+			optimiseMeshes(meshes.Value());
 		}
-		else if (state == ObjReadingState::reading_indices) {
-			++mesh.num_faces;
-			// [ "x/x/x", "x/x/x", "x/x/x" ]
-			auto begin = wm::SplitByElement(line, ' ').begin();
-			for (int i = 0; i < 3; i++) {
-				++begin;
-				// "x/x/x"
-				auto indices = *begin;
-				// "x"
-				auto raw_vertex_index = toFloat(*wm::SplitByElement(indices, '/').begin());
-				// the index start with one, or are negative if the file is big enough.
-				int32_t vertex_index = (raw_vertex_index > 0) ? raw_vertex_index - 1 : vertices.size() + raw_vertex_index;
-				mesh.vertex_buffer_data.emplace_back(vertices[vertex_index].x);
-				mesh.vertex_buffer_data.emplace_back(vertices[vertex_index].y);
-				mesh.vertex_buffer_data.emplace_back(vertices[vertex_index].z);
-			}
+#if BUILD_TARGET == NATIVE_BUILD
+		// web builds have nowhere persistent to write to, they only read what was baked ahead of time.
+		if (meshes.HasValue()) {
+			BakedMesh::write(baked_path, source_hash, meshes.Value())
+				.OnError([&](std::string_view bake_error) {
+					std::cerr << "Failed to bake " << obj_path << ": " << bake_error << std::endl;
+				});
 		}
+#endif
+		return meshes;
 	}
 
-	if (mesh.num_faces != 0 && mesh.vertex_buffer_data.size() != 0) {
-		meshes.emplace_back(std::move(mesh));
+	auto parseObj(const std::filesystem::path& obj_path, size_t max_threads) noexcept -> Expected<std::vector<MeshVariant>, std::string_view>
+	{
+		MappedFile obj_file;
+		if (auto result = obj_file.init(obj_path); result.HasError()) {
+			return { result.Error() };
+		}
+		return loadObj(obj_file, max_threads);
 	}
-	return meshes;
-}
-
-template <>
-auto loadMeshAs<MeshType::positions_and_normals>(const std::string& content) -> Expected<std::vector<MeshVariant>, std::string_view>
-{
-	std::vector<glm::vec3> vertices;
-	std::vector<glm::vec3> normals;
-
-	Mesh<MeshType::positions_and_normals> mesh;
-	mesh.num_faces = 0;
-
-	std::vector<MeshVariant> meshes;
-
-	ObjReadingState state = ObjReadingState::waiting_for_vertices;
 
-	for (const std::span<const char> line : wm::SplitByElement(content, '\n')) {
-		std::span<const char> first_word = *wm::SplitByElement(line, ' ').begin();
-
-		if (state == ObjReadingState::waiting_for_vertices && std::ranges::equal(first_word, std::string_view{ "v" })) {
-			state = ObjReadingState::reading_vertices;
-		}
-		else if (state == ObjReadingState::reading_vertices) {
-			if (std::ranges::equal(first_word, std::string_view{ "v" })) {
-				state = ObjReadingState::reading_vertices;
-			}
-			else if (std::ranges::equal(first_word, std::string_view{ "vn" })) {
-				state = ObjReadingState::reading_normals;
-			}
-			else {
-				state = ObjReadingState::waiting_for_normals;
-			}
-		}
-		else if (state == ObjReadingState::waiting_for_normals) {
-			if (std::ranges::equal(first_word, std::string_view{ "vn" })) {
-				state = ObjReadingState::reading_normals;
-			}
-		}
-		else if (state == ObjReadingState::reading_normals) {
-			if (std::ranges::equal(first_word, std::string_view{ "vn" })) {
-				state = ObjReadingState::reading_normals;
-			}
-			else if (std::ranges::equal(first_word, std::string_view{ "f" })) {
-				state = ObjReadingState::reading_indices;
-			}
-			else {
-				state = ObjReadingState::waiting_for_indices;
-			}
-		}
-		else if (state == ObjReadingState::waiting_for_indices && std::ranges::equal(first_word, std::string_view{ "f" })) {
-			state = ObjReadingState::reading_indices;
-			if (wm::SplitByElement(line, ' ').evaluate().size() != 4) {
-				return { "The obj format is not as expected." };
-			}
+	auto bakeObj(std::filesystem::path obj_path, std::filesystem::path cache_dir) noexcept -> Expected<BakedObj, std::string_view>
+	{
+		if (obj_path.extension() != ".obj") {
+			return { std::string_view{ "The file format must be .obj." } };
 		}
-		else if (state == ObjReadingState::reading_indices && !std::ranges::equal(first_word, std::string_view{ "f" })) {
-			state = ObjReadingState::waiting_for_vertices;
-			Mesh<MeshType::positions_and_normals> other_mesh;
-			std::swap(other_mesh, mesh);
-			meshes.emplace_back(std::move(other_mesh));
+		MappedFile obj_file;
+		if (auto result = obj_file.init(obj_path); result.HasError()) {
+			return { result.Error() };
 		}
 
-		if (state == ObjReadingState::reading_vertices) {
-			glm::vec3 vec3;
-			auto begin = ++(wm::SplitByElement(line, ' ').begin());
-			vec3[0] = toFloat(*begin);
-			++begin;
-			vec3[1] = toFloat(*begin);
-			++begin;
-			vec3[2] = toFloat(*begin);
-			vertices.emplace_back(std::move(vec3));
-		}
-		else if (state == ObjReadingState::reading_normals) {
-			glm::vec3 vec3;
-			auto begin = ++(wm::SplitByElement(line, ' ').begin());
-			vec3[0] = toFloat(*begin);
-			++begin;
-			vec3[1] = toFloat(*begin);
-			++begin;
-			vec3[2] = toFloat(*begin);
-			normals.emplace_back(std::move(vec3));
+		const uint64_t source_hash = CacheFile::hashContent(obj_file.getContent());
+		auto meshes = loadObj(obj_file, 0);
+		if (meshes.HasError()) {
+			return { meshes.Error() };
 		}
-		else if (state == ObjReadingState::reading_indices) {
-			++mesh.num_faces;
-			// [ "x/x/x", "x/x/x", "x/x/x" ]
-			auto begin = wm::SplitByElement(line, ' ').begin();
-			for (int i = 0; i < 3; i++) {
-				++begin;
-				// "x/x/x"
-				auto indices_data = *begin;
-				auto indices_begin = wm::SplitByElement(indices_data, '/').begin();
-
-				auto raw_vertex_index = toFloat(*indices_begin);
-				auto raw_normal_index = toFloat(*(++(++indices_begin)));
-
-				// the index start with one, or are negative if the file is big enough.
-				int32_t vertex_index = (raw_vertex_index > 0) ? raw_vertex_index - 1 : vertices.size() + raw_vertex_index;
-				int32_t normal_index = (raw_normal_index > 0) ? raw_normal_index - 1 : normals.size() + raw_normal_index;
-
-				mesh.vertex_buffer_data.emplace_back(vertices[vertex_index].x);
-				mesh.vertex_buffer_data.emplace_back(vertices[vertex_index].y);
-				mesh.vertex_buffer_data.emplace_back(vertices[vertex_index].z);
-
-				mesh.vertex_buffer_data.emplace_back(normals[normal_index].x);
-				mesh.vertex_buffer_data.emplace_back(normals[normal_index].y);
-				mesh.vertex_buffer_data.emplace_back(normals[normal_index].z);
-			}
+
+		BakedObj baked_obj;
+		baked_obj.reports = optimiseMeshes(meshes.Value());
+		baked_obj.baked_path = BakedMesh::cachePath(cache_dir, source_hash);
+		if (auto result = BakedMesh::write(baked_obj.baked_path, source_hash, meshes.Value()); result.HasError()) {
+			return { result.Error() };
 		}
+		return baked_obj;
 	}
+}
 
-	if (mesh.num_faces != 0 && mesh.vertex_buffer_data.size() != 0) {
-		meshes.emplace_back(std::move(mesh));
+struct ObjVertexKey {
+	uint32_t vertex_index;
+	uint32_t uv_index;
+	uint32_t normal_index;
+
+	bool operator==(const ObjVertexKey& other) const = default;
+};
+
+struct ObjVertexKeyHash {
+	std::size_t operator()(const ObjVertexKey& key) const noexcept
+	{
+		uint64_t h = key.vertex_index;
+		h = (h * 0x9E3779B97F4A7C15ull) ^ key.uv_index;
+		h = (h * 0x9E3779B97F4A7C15ull) ^ key.normal_index;
+		return static_cast<std::size_t>(h ^ (h >> 32));
 	}
-	return meshes;
+};
+
+static float toFloat(const Concept::IsContiguousRangeWithUnderlyingType<char> auto& num_string)
+{
+	return wm::parse::toFloat(std::span<const char>{ num_string.data(), num_string.size() });
 }
 
-template <>
-auto loadMeshAs<MeshType::positions_normals_uvs>(const std::string& content) -> Expected<std::vector<MeshVariant>, std::string_view>
+static int32_t toInt(const Concept::IsContiguousRangeWithUnderlyingType<char> auto& num_string)
 {
+	return wm::parse::toInt(std::span<const char>{ num_string.data(), num_string.size() });
+}
+
+// One newline aligned slice of an obj file, parsed independently of the other slices.
+// Positive face indices are already absolute, negative ones are kept relative to the chunk's own
+// element counts until the merge knows how many elements came before the chunk.
+struct ObjChunk {
+	enum RelativeBits : uint8_t {
+		vertex_is_relative = 1 << 0,
+		uv_is_relative = 1 << 1,
+		normal_is_relative = 1 << 2,
+	};
+	struct Corner {
+		int32_t vertex;
+		int32_t uv;
+		int32_t normal;
+		uint8_t relative_bits;
+	};
+
+	std::span<const char> content;
 	std::vector<glm::vec3> vertices;
 	std::vector<glm::vec2> uvs;
 	std::vector<glm::vec3> normals;
+	std::vector<std::array<Corner, 3>> faces;
+	// the number of faces read so far at each 'o'.
+	std::vector<size_t> object_starts;
+	// which attributes the faces reference, the richest layout the whole file supports is decided from these.
+	bool every_face_has_uvs = true;
+	bool every_face_has_normals = true;
+
+	// how many of each element the preceding chunks hold, filled in by the merge.
+	size_t vertex_base = 0;
+	size_t uv_base = 0;
+	size_t normal_base = 0;
+};
 
-	std::vector<MeshVariant> meshes;
-
-	Mesh<MeshType::positions_normals_uvs> mesh;
-	mesh.num_faces = 0;
-
-	int32_t vertices_index_offset = 0;
-	int32_t uvs_index_offset = 0;
-	int32_t normals_index_offset = 0;
-
-	ObjReadingState state = ObjReadingState::waiting_for_vertices;
-#if 0
-	for (const std::span<const char> line : wm::SplitByElement(content, '\n')) {
-		std::span<const char> first_word = *wm::SplitByElement(line, ' ').begin();
+static auto chooseChunkCount(size_t content_size, size_t max_threads) -> size_t
+{
+#if BUILD_TARGET == NATIVE_BUILD
+	// below this much text per thread, starting the thread costs more than it saves.
+	constexpr size_t min_bytes_per_chunk = 1024 * 1024;
+	const size_t thread_count = max_threads != 0 ? max_threads : std::max(std::thread::hardware_concurrency(), 1u);
+	return std::clamp(content_size / min_bytes_per_chunk, size_t{ 1 }, thread_count);
+#else
+	// web builds are not compiled with pthreads.
+	return 1;
+#endif
+}
 
-		if (state == ObjReadingState::waiting_for_vertices && std::ranges::equal(first_word, std::string_view{ "v" })) {
-			state = ObjReadingState::reading_vertices;
-		}
-		else if (state == ObjReadingState::reading_vertices) {
-			if (std::ranges::equal(first_word, std::string_view{ "v" })) {
-				state = ObjReadingState::reading_vertices;
-			}
-			else if (std::ranges::equal(first_word, std::string_view{ "vt" })) {
-				state = ObjReadingState::reading_uvs;
-			}
-			else {
-				state = ObjReadingState::waiting_for_uvs;
-			}
-		}
-		else if (state == ObjReadingState::waiting_for_uvs) {
-			if (std::ranges::equal(first_word, std::string_view{ "vt" })) {
-				state = ObjReadingState::reading_uvs;
-			}
-		}
-		else if (state == ObjReadingState::reading_uvs) {
-			if (std::ranges::equal(first_word, std::string_view{ "vt" })) {
-				state = ObjReadingState::reading_uvs;
-			}
-			else if (std::ranges::equal(first_word, std::string_view{ "vn" })) {
-				state = ObjReadingState::reading_normals;
-			}
-			else {
-				state = ObjReadingState::waiting_for_normals;
-			}
-		}
-		else if (state == ObjReadingState::waiting_for_normals) {
-			if (std::ranges::equal(first_word, std::string_view{ "vn" })) {
-				state = ObjReadingState::reading_normals;
-			}
-		}
-		else if (state == ObjReadingState::reading_normals) {
-			if (std::ranges::equal(first_word, std::string_view{ "vn" })) {
-				state = ObjReadingState::reading_normals;
-			}
-			else if (std::ranges::equal(first_word, std::string_view{ "f" })) {
-				state = ObjReadingState::reading_indices;
-			}
-			else {
-				state = ObjReadingState::waiting_for_indices;
-			}
-		}
-		else if (state == ObjReadingState::waiting_for_indices && std::ranges::equal(first_word, std::string_view{ "f" })) {
-			state = ObjReadingState::reading_indices;
-		}
-		else if (state == ObjReadingState::reading_indices && std::ranges::equal(first_word, std::string_view{ "o" })) {
-			state = ObjReadingState::waiting_for_vertices;
-			Mesh<MeshType::positions_normals_uvs> other_mesh;
-			std::swap(other_mesh, mesh);
-			meshes.emplace_back(std::move(other_mesh));
-
-			vertices_index_offset += vertices.size();
-			normals_index_offset += normals.size();
-			uvs_index_offset += uvs.size();
-
-			vertices.clear();
-			normals.clear();
-			uvs.clear();
-		}
+static auto splitIntoChunks(std::span<const char> content, size_t chunk_count) -> std::vector<ObjChunk>
+{
+	std::vector<ObjChunk> chunks;
+	chunks.reserve(chunk_count);
+
+	const size_t target_size = content.size() / chunk_count;
+	const char* begin = content.data();
+	const char* end = content.data() + content.size();
+	while (begin != end) {
+		const char* split = (static_cast<size_t>(end - begin) > target_size) ? begin + target_size : end;
+		split = std::find(split, end, '\n');
+		if (split != end) {
+			++split;
+		}
+		chunks.emplace_back().content = std::span<const char>{ begin, split };
+		begin = split;
+	}
+	return chunks;
+}
 
-		if (state == ObjReadingState::reading_vertices) {
-			glm::vec3 vec3;
-			auto begin = ++(wm::SplitByElement(line, ' ').begin());
-			vec3[0] = toFloat(*begin);
-			++begin;
-			vec3[1] = toFloat(*begin);
-			++begin;
-			vec3[2] = toFloat(*begin);
-			vertices.emplace_back(std::move(vec3));
-		}
-		else if (state == ObjReadingState::reading_normals) {
-			glm::vec3 vec3;
-			auto begin = ++(wm::SplitByElement(line, ' ').begin());
-			vec3[0] = toFloat(*begin);
-			++begin;
-			vec3[1] = toFloat(*begin);
-			++begin;
-			vec3[2] = toFloat(*begin);
-			normals.emplace_back(std::move(vec3));
-		}
-		else if (state == ObjReadingState::reading_uvs) {
-			glm::vec2 vec2;
-			auto begin = ++(wm::SplitByElement(line, ' ').begin());
-			vec2[0] = toFloat(*begin);
-			++begin;
-			vec2[1] = toFloat(*begin);
-			uvs.emplace_back(std::move(vec2));
+static void parseChunk(ObjChunk& chunk, const MappedFile& obj_file)
+{
+	// the index start with one, or are negative if relative to the elements read so far.
+	auto toIndex = [](int32_t raw_index, size_t count, uint8_t relative_bit, uint8_t& relative_bits) -> int32_t {
+		if (raw_index > 0) {
+			return raw_index - 1;
 		}
-		else if (state == ObjReadingState::reading_indices) {
-			++mesh.num_faces;
-			// [ "x/x/x", "x/x/x", "x/x/x" ]
-			auto split = wm::SplitByElement(line, ' ');
-			for (auto iter = ++split.begin(); iter != split.end(); ++iter) {
-				// "x/x/x"
-				auto indices_data = *iter;
-				auto indices_begin = wm::SplitByElement(indices_data, '/').begin();
-
-
-				auto raw_vertex_index = toFloat(*indices_begin);
-				auto raw_uv_index = toFloat(*(++indices_begin));
-				auto raw_normal_index = toFloat(*(++indices_begin));
-
-				// the index start with one, or are negative if the file is big enough.
-				int32_t vertex_index = (raw_vertex_index > 0) ? raw_vertex_index - 1 - vertices_index_offset : vertices.size() + raw_vertex_index;
-				int32_t normal_index = (raw_normal_index > 0) ? raw_normal_index - 1 - normals_index_offset : normals.size() + raw_normal_index;
-				int32_t uv_index = (raw_uv_index > 0) ? raw_uv_index - 1 - uvs_index_offset : uvs.size() + raw_uv_index;
+		relative_bits |= relative_bit;
+		return static_cast<int32_t>(count) + raw_index;
+	};
 
-				mesh.vertex_buffer_data.emplace_back(vertices[vertex_index].x);
-				mesh.vertex_buffer_data.emplace_back(vertices[vertex_index].y);
-				mesh.vertex_buffer_data.emplace_back(vertices[vertex_index].z);
+	// lines are parsed front to back, so the consumed part of the file can be let go of as we go.
+	constexpr size_t release_granularity = 8 * 1024 * 1024;
+	const char* released_up_to = chunk.content.data();
 
-				mesh.vertex_buffer_data.emplace_back(normals[normal_index].x);
-				mesh.vertex_buffer_data.emplace_back(normals[normal_index].y);
-				mesh.vertex_buffer_data.emplace_back(normals[normal_index].z);
-
-				mesh.vertex_buffer_data.emplace_back(uvs[uv_index].x);
-				mesh.vertex_buffer_data.emplace_back(uvs[uv_index].y);
-			}
+	for (const std::span<const char> line : wm::SplitByElement(chunk.content, '\n'))
+	{
+		if (static_cast<size_t>(line.data() - released_up_to) >= release_granularity) {
+			obj_file.release({ released_up_to, line.data() });
+			released_up_to = line.data();
 		}
-	}
-#else 
+		// a face line is the longest we read, "f" followed by three "v/vt/vn" corners.
+		// splitting on both delimiters at once gives every token of the line in one pass.
+		std::array<std::span<const char>, 10> tokens{};
+		const size_t token_count = wm::SplitByElements(line, std::array{ ' ', '/' }).evaluateInto(tokens);
 
-	for (const std::span<const char> line : wm::SplitByElement(content, '\n'))
-	{
-		auto word_range = wm::SplitByElement(line, ' ');
-		auto first_word = std::string_view{ *word_range.begin() };
+		auto first_word = std::string_view{ tokens[0].begin(), tokens[0].end() };
 		if (first_word == "o")
 		{
-			if (mesh.num_faces != 0 && mesh.vertex_buffer_data.size() != 0) {
-				meshes.emplace_back(std::move(mesh));
-			}
+			chunk.object_starts.emplace_back(chunk.faces.size());
 		}
 		else if (first_word == "v")
 		{
-			glm::vec3 vec3;
-			auto begin = ++(wm::SplitByElement(line, ' ').begin());
-			vec3[0] = toFloat(*begin);
-			++begin;
-			vec3[1] = toFloat(*begin);
-			++begin;
-			vec3[2] = toFloat(*begin);
-			vertices.emplace_back(std::move(vec3));
+			chunk.vertices.emplace_back(toFloat(tokens[1]), toFloat(tokens[2]), toFloat(tokens[3]));
 		}
 		else if (first_word == "vt")
 		{
-			glm::vec2 vec2;
-			auto begin = ++(wm::SplitByElement(line, ' ').begin());
-			vec2[0] = toFloat(*begin);
-			++begin;
-			vec2[1] = toFloat(*begin);
-			uvs.emplace_back(std::move(vec2));
+			chunk.uvs.emplace_back(toFloat(tokens[1]), toFloat(tokens[2]));
 		}
 		else if (first_word == "vn")
 		{
-			glm::vec3 vec3;
-			auto begin = ++(wm::SplitByElement(line, ' ').begin());
-			vec3[0] = toFloat(*begin);
-			++begin;
-			vec3[1] = toFloat(*begin);
-			++begin;
-			vec3[2] = toFloat(*begin);
-			normals.emplace_back(std::move(vec3));
+			chunk.normals.emplace_back(toFloat(tokens[1]), toFloat(tokens[2]), toFloat(tokens[3]));
 		}
 		else if (first_word == "f")
 		{
-			++mesh.num_faces;
-			// [ "x/x/x", "x/x/x", "x/x/x" ]
-#if 1
-			auto begin = wm::SplitByElement(line, ' ').begin();
-			for (int i = 0; i < 3; i++) {
-				++begin;
-				// "x/x/x"
-				auto indices_data = *begin;
-				auto indices_begin = wm::SplitByElement(indices_data, '/').begin();
-
-				auto raw_vertex_index = toFloat(*indices_begin);
-				auto raw_uv_index = toFloat(*(++indices_begin));
-				auto raw_normal_index = toFloat(*(++indices_begin));
-
-				// the index start with one, or are negative if the file is big enough.
-				int32_t vertex_index = (raw_vertex_index > 0) ? raw_vertex_index - 1 : vertices.size() + raw_vertex_index;
-				int32_t normal_index = (raw_normal_index > 0) ? raw_normal_index - 1 : normals.size() + raw_normal_index;
-				int32_t uv_index = (raw_normal_index > 0) ? raw_uv_index - 1 : uvs.size() + raw_uv_index;
-
-
-				mesh.vertex_buffer_data.emplace_back(vertices[vertex_index].x);
-				mesh.vertex_buffer_data.emplace_back(vertices[vertex_index].y);
-				mesh.vertex_buffer_data.emplace_back(vertices[vertex_index].z);
-
-				mesh.vertex_buffer_data.emplace_back(normals[normal_index].x);
-				mesh.vertex_buffer_data.emplace_back(normals[normal_index].y);
-				mesh.vertex_buffer_data.emplace_back(normals[normal_index].z);
-
-				mesh.vertex_buffer_data.emplace_back(uvs[uv_index].x);
-				mesh.vertex_buffer_data.emplace_back(uvs[uv_index].y);
+			// consecutive delimiters are skipped, so "v//vn" has as many tokens as "v/vt" and needs a closer look.
+			const size_t tokens_per_corner = std::min<size_t>((token_count - 1) / 3, 3);
+			const bool has_uvs = tokens_per_corner == 3 || (tokens_per_corner == 2 && std::string_view{ line.data(), line.size() }.find("//") == std::string_view::npos);
+			const bool has_normals = tokens_per_corner == 3 || (tokens_per_corner == 2 && !has_uvs);
+			chunk.every_face_has_uvs &= has_uvs;
+			chunk.every_face_has_normals &= has_normals;
+
+			auto& face = chunk.faces.emplace_back();
+			// [ "f", "v", "vt", "vn", "v", "vt", "vn", "v", "vt", "vn" ] with vt and or vn missing.
+			for (size_t i = 0; i < face.size(); ++i) {
+				const std::span<const char>* corner_tokens = tokens.data() + 1 + i * tokens_per_corner;
+
+				auto& corner = face[i];
+				corner.relative_bits = 0;
+				corner.vertex = toIndex(toInt(corner_tokens[0]), chunk.vertices.size(), ObjChunk::vertex_is_relative, corner.relative_bits);
+				corner.uv = has_uvs ? toIndex(toInt(corner_tokens[1]), chunk.uvs.size(), ObjChunk::uv_is_relative, corner.relative_bits) : 0;
+				corner.normal = has_normals ? toIndex(toInt(corner_tokens[has_uvs ? 2 : 1]), chunk.normals.size(), ObjChunk::normal_is_relative, corner.relative_bits) : 0;
 			}
-#else 
-			auto begin = wm::SplitByElement(line, ' ').begin();
-			for (int i = 0; i < 3; i++) {
-				++begin;
-				// "x/x/x"
-				auto indices_data = *begin;
-				auto indices_begin = wm::SplitByElement(indices_data, '/').begin();
-
-				int num_count = 0;
-				for (auto num : wm::SplitByElement(indices_data, '/'))
-				{
-					++num_count;
-					if (num_count == 0)
-					{
-						float raw_vertex_index = toFloat(num);
-						int32_t vertex_index = (raw_vertex_index > 0) ? raw_vertex_index - 1 : vertices.size() + raw_vertex_index;
-						mesh.vertex_buffer_data.emplace_back(vertices[vertex_index].x);
-						mesh.vertex_buffer_data.emplace_back(vertices[vertex_index].y);
-						mesh.vertex_buffer_data.emplace_back(vertices[vertex_index].z);
+		}
+	}
+	obj_file.release({ released_up_to, chunk.content.data() + chunk.content.size() });
+}
 
-					}
-					else if (num_count == 1)
-					{
-						float raw_uv_index = toFloat(num);
-						int32_t vertex_index = (raw_vertex_index > 0) ? raw_vertex_index - 1 : vertices.size() + raw_vertex_index;
-						mesh.vertex_buffer_data.emplace_back(vertices[vertex_index].x);
-						mesh.vertex_buffer_data.emplace_back(vertices[vertex_index].y);
-						mesh.vertex_buffer_data.emplace_back(vertices[vertex_index].z);
+// Merges the parsed chunks into meshes of one layout, one mesh per object. The per vertex work is generated
+// for the layout at compile time, attributes the layout doesn't have are never looked at.
+template <MeshType type>
+static auto buildMeshes(std::vector<ObjChunk>& chunks, const std::vector<glm::vec3>& vertices, const std::vector<glm::vec2>& uvs, const std::vector<glm::vec3>& normals)
+	-> Expected<std::vector<MeshVariant>, std::string_view>
+{
+	constexpr size_t stride = Mesh<type>::floats_per_vertex_attribute;
+	std::vector<MeshVariant> meshes;
 
-					}
-					else if (num_count == 2)
-					{
+	Mesh<type> mesh;
+	mesh.num_faces = 0;
 
-					}
-				}
+	// every unique (v, vt, vn) triple of the current object becomes a single vertex.
+	std::unordered_map<ObjVertexKey, uint32_t, ObjVertexKeyHash> vertex_lookup;
+
+	auto finishMesh = [&]() {
+		if (mesh.num_faces != 0 && mesh.vertex_buffer_data.size() != 0) {
+			const float* position = mesh.vertex_buffer_data.data();
+			mesh.bounds_min = mesh.bounds_max = glm::vec3{ position[0], position[1], position[2] };
+			for (size_t i = 0; i < mesh.vertex_buffer_data.size(); i += stride) {
+				position = mesh.vertex_buffer_data.data() + i;
+				mesh.bounds_min = glm::min(mesh.bounds_min, glm::vec3{ position[0], position[1], position[2] });
+				mesh.bounds_max = glm::max(mesh.bounds_max, glm::vec3{ position[0], position[1], position[2] });
+			}
+			meshes.emplace_back(std::move(mesh));
+		}
+		mesh = Mesh<type>{};
+		mesh.num_faces = 0;
+		vertex_lookup.clear();
+	};
+
+	auto resolve = [](int32_t index, bool is_relative, size_t base) -> uint32_t {
+		return static_cast<uint32_t>(is_relative ? index + static_cast<int64_t>(base) : index);
+	};
+
+	for (ObjChunk& chunk : chunks) {
+		auto object_start = chunk.object_starts.begin();
+		for (size_t face_index = 0; face_index < chunk.faces.size(); ++face_index) {
+			for (; object_start != chunk.object_starts.end() && *object_start == face_index; ++object_start) {
+				finishMesh();
+			}
 
-				auto raw_uv_index = toFloat(*(++indices_begin));
-				auto raw_normal_index = toFloat(*(++indices_begin));
+			++mesh.num_faces;
+			for (const ObjChunk::Corner& corner : chunk.faces[face_index]) {
+				ObjVertexKey key = {
+					.vertex_index = resolve(corner.vertex, corner.relative_bits & ObjChunk::vertex_is_relative, chunk.vertex_base),
+					.uv_index = 0,
+					.normal_index = 0
+				};
+				if constexpr (hasUvs(type)) {
+					key.uv_index = resolve(corner.uv, corner.relative_bits & ObjChunk::uv_is_relative, chunk.uv_base);
+				}
+				if constexpr (hasNormals(type)) {
+					key.normal_index = resolve(corner.normal, corner.relative_bits & ObjChunk::normal_is_relative, chunk.normal_base);
+				}
 
-				int32_t normal_index = (raw_normal_index > 0) ? raw_normal_index - 1 : normals.size() + raw_normal_index;
-				int32_t uv_index = (raw_normal_index > 0) ? raw_uv_index - 1 : uvs.size() + raw_uv_index;
+				auto next_index = static_cast<uint32_t>(mesh.vertex_buffer_data.size() / stride);
+				auto [lookup, is_new_vertex] = vertex_lookup.try_emplace(key, next_index);
 
-				mesh.vertex_buffer_data.emplace_back(normals[normal_index].x);
-				mesh.vertex_buffer_data.emplace_back(normals[normal_index].y);
-				mesh.vertex_buffer_data.emplace_back(normals[normal_index].z);
+				if (is_new_vertex) {
+					// out of range indices wrap to huge unsigned values, so one comparison covers negative ones too.
+					bool is_in_range = key.vertex_index < vertices.size();
+					if constexpr (hasUvs(type)) {
+						is_in_range &= key.uv_index < uvs.size();
+					}
+					if constexpr (hasNormals(type)) {
+						is_in_range &= key.normal_index < normals.size();
+					}
+					if (!is_in_range) {
+						return { "The obj references an element it doesn't define." };
+					}
 
-				mesh.vertex_buffer_data.emplace_back(uvs[uv_index].x);
-				mesh.vertex_buffer_data.emplace_back(uvs[uv_index].y);
+					mesh.vertex_buffer_data.emplace_back(vertices[key.vertex_index].x);
+					mesh.vertex_buffer_data.emplace_back(vertices[key.vertex_index].y);
+					mesh.vertex_buffer_data.emplace_back(vertices[key.vertex_index].z);
+					if constexpr (hasNormals(type)) {
+						mesh.vertex_buffer_data.emplace_back(normals[key.normal_index].x);
+						mesh.vertex_buffer_data.emplace_back(normals[key.normal_index].y);
+						mesh.vertex_buffer_data.emplace_back(normals[key.normal_index].z);
+					}
+					if constexpr (hasUvs(type)) {
+						mesh.vertex_buffer_data.emplace_back(uvs[key.uv_index].x);
+						mesh.vertex_buffer_data.emplace_back(uvs[key.uv_index].y);
+					}
+				}
+				mesh.index_buffer_data.emplace_back(lookup->second);
 			}
-#endif 
 		}
+		for (; object_start != chunk.object_starts.end(); ++object_start) {
+			finishMesh();
+		}
+		chunk.faces = {};
 	}
-#endif
-	if (mesh.num_faces != 0 && mesh.vertex_buffer_data.size() != 0) {
-		meshes.emplace_back(std::move(mesh));
-	}
+	finishMesh();
 	return meshes;
 }
 
+static auto loadObj(const MappedFile& obj_file, size_t max_threads) -> Expected<std::vector<MeshVariant>, std::string_view>
+{
+	std::span<const char> content = obj_file.getContent();
+
+	// large files are parsed in parallel, the merge below runs in file order so the result is the same either way.
+	std::vector<ObjChunk> chunks = splitIntoChunks(content, chooseChunkCount(content.size(), max_threads));
+	{
+		std::vector<std::jthread> workers;
+		for (size_t i = 1; i < chunks.size(); ++i) {
+			workers.emplace_back([&chunks, &obj_file, i]() { parseChunk(chunks[i], obj_file); });
+		}
+		if (!chunks.empty()) {
+			parseChunk(chunks.front(), obj_file);
+		}
+	}
+
+	std::vector<glm::vec3> vertices;
+	std::vector<glm::vec2> uvs;
+	std::vector<glm::vec3> normals;
+	bool every_face_has_uvs = true;
+	bool every_face_has_normals = true;
+	auto append = [](auto& all, auto& part) {
+		if (all.empty()) {
+			all = std::move(part);
+		}
+		else {
+			all.insert(all.end(), part.begin(), part.end());
+		}
+		part = {};
+	};
+	for (ObjChunk& chunk : chunks) {
+		chunk.vertex_base = vertices.size();
+		chunk.uv_base = uvs.size();
+		chunk.normal_base = normals.size();
+		append(vertices, chunk.vertices);
+		append(uvs, chunk.uvs);
+		append(normals, chunk.normals);
+		every_face_has_uvs &= chunk.every_face_has_uvs;
+		every_face_has_normals &= chunk.every_face_has_normals;
+	}
+
+	// there is no positions and uvs layout, uvs without normals load as positions only.
+	if (every_face_has_normals && every_face_has_uvs) {
+		return buildMeshes<MeshType::positions_normals_uvs>(chunks, vertices, uvs, normals);
+	}
+	if (every_face_has_normals) {
+		return buildMeshes<MeshType::positions_and_normals>(chunks, vertices, uvs, normals);
+	}
+	return buildMeshes<MeshType::positions_only>(chunks, vertices, uvs, normals);
+}
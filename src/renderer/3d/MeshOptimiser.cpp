@@ -0,0 +1,370 @@
+#include "renderer/3d/MeshOptimiser.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace {
+	constexpr uint32_t invalid_index = std::numeric_limits<uint32_t>::max();
+
+	// Simulates a fifo post transform cache, a vertex is in the cache while it was transformed in the last cache_size misses.
+	class FifoCache {
+		std::vector<size_t> m_timestamps;
+		size_t m_cache_size;
+		size_t m_time;
+
+	public:
+		FifoCache(size_t vertex_count, size_t cache_size)
+			: m_timestamps(vertex_count, 0)
+			, m_cache_size(cache_size)
+			, m_time(cache_size + 1)
+		{
+		}
+
+		// returns whether the vertex had to be transformed.
+		auto access(uint32_t vertex) -> bool
+		{
+			if (m_time - m_timestamps[vertex] > m_cache_size) {
+				m_timestamps[vertex] = m_time++;
+				return true;
+			}
+			return false;
+		}
+
+		auto triangleMisses(const uint32_t* triangle) -> uint32_t
+		{
+			return access(triangle[0]) + access(triangle[1]) + access(triangle[2]);
+		}
+
+		void clear()
+		{
+			m_time += m_cache_size + 1;
+		}
+	};
+
+	// The scoring from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+	namespace Forsyth {
+		constexpr size_t cache_size = 32;
+		constexpr float cache_decay_power = 1.5f;
+		constexpr float last_triangle_score = 0.75f;
+		constexpr float valence_boost_scale = 2.0f;
+		constexpr float valence_boost_power = 0.5f;
+
+		auto vertexScore(int32_t cache_position, uint32_t live_triangles) -> float
+		{
+			if (live_triangles == 0) {
+				// nothing left to draw with it, so it shouldn't pull anything towards it.
+				return -1.0f;
+			}
+			float score = 0.0f;
+			if (cache_position >= 0) {
+				if (cache_position < 3) {
+					// it was used by the last triangle, its score is fixed so that the order within a strip doesn't matter.
+					score = last_triangle_score;
+				}
+				else {
+					const float scale = 1.0f / (cache_size - 3);
+					score = std::pow(1.0f - (cache_position - 3) * scale, cache_decay_power);
+				}
+			}
+			// vertices with few triangles left are boosted, so lone triangles get finished off rather than left behind.
+			score += valence_boost_scale * std::pow(static_cast<float>(live_triangles), -valence_boost_power);
+			return score;
+		}
+	}
+
+	auto positionOf(std::span<const float> vertex_data, size_t floats_per_vertex, uint32_t vertex) -> glm::vec3
+	{
+		const float* position = vertex_data.data() + vertex * floats_per_vertex;
+		return { position[0], position[1], position[2] };
+	}
+
+	// The clusters of the cache optimised triangles, ordered outside first. threshold only guides where the clusters
+	// are split, the cost of the result is measured by the caller.
+	auto orderClustersByFacing(std::span<const uint32_t> indices, std::span<const float> vertex_data, size_t floats_per_vertex, float threshold) -> std::vector<uint32_t>
+	{
+		const size_t triangle_count = indices.size() / 3;
+		const size_t vertex_count = vertex_data.size() / floats_per_vertex;
+
+		// hard boundaries are where the cache optimised order already starts over, all three vertices missing the cache.
+		std::vector<size_t> hard_boundaries;
+		{
+			FifoCache cache(vertex_count, MeshOptimiser::analysis_cache_size);
+			for (size_t triangle = 0; triangle < triangle_count; ++triangle) {
+				if (cache.triangleMisses(indices.data() + triangle * 3) == 3) {
+					hard_boundaries.emplace_back(triangle);
+				}
+			}
+			hard_boundaries.emplace_back(triangle_count);
+		}
+
+		// soft boundaries split the hard clusters further, wherever the cluster so far is already about as
+		// cache efficient as the whole hard cluster, so splitting there costs little.
+		std::vector<size_t> clusters;
+		{
+			FifoCache cache(vertex_count, MeshOptimiser::analysis_cache_size);
+			for (size_t i = 0; i + 1 < hard_boundaries.size(); ++i) {
+				const size_t start = hard_boundaries[i];
+				const size_t end = hard_boundaries[i + 1];
+
+				cache.clear();
+				size_t cluster_misses = 0;
+				for (size_t triangle = start; triangle < end; ++triangle) {
+					cluster_misses += cache.triangleMisses(indices.data() + triangle * 3);
+				}
+				const float cluster_threshold = threshold * static_cast<float>(cluster_misses) / static_cast<float>(end - start);
+
+				clusters.emplace_back(start);
+				cache.clear();
+				size_t running_misses = 0;
+				size_t running_triangles = 0;
+				for (size_t triangle = start; triangle < end; ++triangle) {
+					running_misses += cache.triangleMisses(indices.data() + triangle * 3);
+					++running_triangles;
+					if (triangle + 1 < end && static_cast<float>(running_misses) / running_triangles <= cluster_threshold) {
+						clusters.emplace_back(triangle + 1);
+						cache.clear();
+						running_misses = 0;
+						running_triangles = 0;
+					}
+				}
+			}
+			clusters.emplace_back(triangle_count);
+		}
+
+		glm::vec3 mesh_centroid{ 0.0f };
+		for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+			mesh_centroid += positionOf(vertex_data, floats_per_vertex, static_cast<uint32_t>(vertex));
+		}
+		mesh_centroid /= static_cast<float>(std::max(vertex_count, size_t{ 1 }));
+
+		// clusters facing away from the centre are on the outside of the mesh, draw those first.
+		const size_t cluster_count = clusters.size() - 1;
+		std::vector<float> cluster_keys(cluster_count);
+		for (size_t cluster = 0; cluster < cluster_count; ++cluster) {
+			glm::vec3 centroid{ 0.0f };
+			glm::vec3 normal{ 0.0f };
+			float area = 0.0f;
+			for (size_t triangle = clusters[cluster]; triangle < clusters[cluster + 1]; ++triangle) {
+				const glm::vec3 a = positionOf(vertex_data, floats_per_vertex, indices[triangle * 3 + 0]);
+				const glm::vec3 b = positionOf(vertex_data, floats_per_vertex, indices[triangle * 3 + 1]);
+				const glm::vec3 c = positionOf(vertex_data, floats_per_vertex, indices[triangle * 3 + 2]);
+				// the cross product's length is twice the area, so it weights both sums by area.
+				const glm::vec3 weighted_normal = glm::cross(b - a, c - a);
+				const float weight = glm::length(weighted_normal);
+				centroid += (a + b + c) * (weight / 3.0f);
+				normal += weighted_normal;
+				area += weight;
+			}
+			if (area == 0.0f) {
+				cluster_keys[cluster] = 0.0f;
+				continue;
+			}
+			centroid /= area;
+			const float normal_length = glm::length(normal);
+			cluster_keys[cluster] = (normal_length == 0.0f) ? 0.0f : glm::dot(centroid - mesh_centroid, normal / normal_length);
+		}
+
+		std::vector<uint32_t> order(cluster_count);
+		std::iota(order.begin(), order.end(), 0u);
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) { return cluster_keys[lhs] > cluster_keys[rhs]; });
+
+		std::vector<uint32_t> output;
+		output.reserve(triangle_count * 3);
+		for (uint32_t cluster : order) {
+			output.insert(output.end(), indices.begin() + clusters[cluster] * 3, indices.begin() + clusters[cluster + 1] * 3);
+		}
+		return output;
+	}
+}
+
+namespace MeshOptimiser {
+	auto analyseVertexCache(std::span<const uint32_t> indices, size_t vertex_count, size_t cache_size) -> VertexCacheStatistics
+	{
+		VertexCacheStatistics statistics;
+		statistics.triangle_count = indices.size() / 3;
+
+		FifoCache cache(vertex_count, cache_size);
+		for (size_t i = 0; i + 3 <= indices.size(); i += 3) {
+			statistics.vertices_transformed += cache.triangleMisses(indices.data() + i);
+		}
+
+		if (statistics.triangle_count != 0) {
+			statistics.acmr = static_cast<float>(statistics.vertices_transformed) / statistics.triangle_count;
+		}
+		if (vertex_count != 0) {
+			statistics.atvr = static_cast<float>(statistics.vertices_transformed) / vertex_count;
+		}
+		return statistics;
+	}
+
+	void optimiseVertexCache(std::span<uint32_t> indices, size_t vertex_count)
+	{
+		const size_t triangle_count = indices.size() / 3;
+		if (triangle_count == 0) {
+			return;
+		}
+
+		// the triangles using each vertex, packed one vertex after another. a vertex's live triangles are the
+		// first live_triangles[vertex] entries of its range, drawn ones get swapped out past the end.
+		std::vector<uint32_t> live_triangles(vertex_count, 0);
+		for (size_t i = 0; i < triangle_count * 3; ++i) {
+			++live_triangles[indices[i]];
+		}
+		std::vector<uint32_t> adjacency_offsets(vertex_count + 1, 0);
+		std::inclusive_scan(live_triangles.begin(), live_triangles.end(), adjacency_offsets.begin() + 1);
+		std::vector<uint32_t> adjacency(triangle_count * 3);
+		{
+			std::vector<uint32_t> fill(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+			for (size_t i = 0; i < triangle_count * 3; ++i) {
+				adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		std::vector<int32_t> cache_positions(vertex_count, -1);
+		std::vector<float> vertex_scores(vertex_count);
+		for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+			vertex_scores[vertex] = Forsyth::vertexScore(-1, live_triangles[vertex]);
+		}
+
+		std::vector<float> triangle_scores(triangle_count);
+		std::vector<bool> is_drawn(triangle_count, false);
+		uint32_t best_triangle = 0;
+		for (size_t triangle = 0; triangle < triangle_count; ++triangle) {
+			const uint32_t* corners = indices.data() + triangle * 3;
+			triangle_scores[triangle] = vertex_scores[corners[0]] + vertex_scores[corners[1]] + vertex_scores[corners[2]];
+			if (triangle_scores[triangle] > triangle_scores[best_triangle]) {
+				best_triangle = static_cast<uint32_t>(triangle);
+			}
+		}
+
+		// the lru cache, plus room for the three vertices of the triangle being added.
+		std::array<uint32_t, Forsyth::cache_size + 3> cache;
+		std::array<uint32_t, Forsyth::cache_size + 3> next_cache;
+		size_t cache_count = 0;
+
+		std::vector<uint32_t> output(triangle_count * 3);
+		size_t dead_end_cursor = 0;
+
+		for (size_t drawn = 0; drawn < triangle_count; ++drawn) {
+			if (best_triangle == invalid_index) {
+				// nothing in the cache has triangles left, carry on from the first undrawn triangle in the input order.
+				while (is_drawn[dead_end_cursor]) {
+					++dead_end_cursor;
+				}
+				best_triangle = static_cast<uint32_t>(dead_end_cursor);
+			}
+
+			const std::array<uint32_t, 3> corners = {
+				indices[best_triangle * 3 + 0],
+				indices[best_triangle * 3 + 1],
+				indices[best_triangle * 3 + 2]
+			};
+			std::copy(corners.begin(), corners.end(), output.begin() + drawn * 3);
+			is_drawn[best_triangle] = true;
+
+			for (uint32_t vertex : corners) {
+				uint32_t* live_begin = adjacency.data() + adjacency_offsets[vertex];
+				uint32_t* live_end = live_begin + live_triangles[vertex];
+				std::iter_swap(std::find(live_begin, live_end, best_triangle), live_end - 1);
+				--live_triangles[vertex];
+			}
+
+			// the triangle's vertices move to the front, everything else shuffles back in use order.
+			size_t next_cache_count = 0;
+			for (uint32_t vertex : corners) {
+				next_cache[next_cache_count++] = vertex;
+			}
+			for (size_t i = 0; i < cache_count; ++i) {
+				const uint32_t vertex = cache[i];
+				if (vertex != corners[0] && vertex != corners[1] && vertex != corners[2]) {
+					next_cache[next_cache_count++] = vertex;
+				}
+			}
+			std::swap(cache, next_cache);
+			cache_count = next_cache_count;
+
+			// rescore every vertex whose position changed, including those just pushed out, and the triangles that use them.
+			for (size_t i = 0; i < cache_count; ++i) {
+				const uint32_t vertex = cache[i];
+				cache_positions[vertex] = (i < Forsyth::cache_size) ? static_cast<int32_t>(i) : -1;
+				const float score = Forsyth::vertexScore(cache_positions[vertex], live_triangles[vertex]);
+				const float score_change = score - vertex_scores[vertex];
+				vertex_scores[vertex] = score;
+
+				const uint32_t* live_begin = adjacency.data() + adjacency_offsets[vertex];
+				for (const uint32_t* triangle = live_begin; triangle != live_begin + live_triangles[vertex]; ++triangle) {
+					triangle_scores[*triangle] += score_change;
+				}
+			}
+			cache_count = std::min(cache_count, Forsyth::cache_size);
+
+			// only triangles touching the cache changed score, so the next best one is one of them.
+			best_triangle = invalid_index;
+			float best_score = -std::numeric_limits<float>::max();
+			for (size_t i = 0; i < cache_count; ++i) {
+				const uint32_t vertex = cache[i];
+				const uint32_t* live_begin = adjacency.data() + adjacency_offsets[vertex];
+				for (const uint32_t* triangle = live_begin; triangle != live_begin + live_triangles[vertex]; ++triangle) {
+					if (triangle_scores[*triangle] > best_score) {
+						best_score = triangle_scores[*triangle];
+						best_triangle = *triangle;
+					}
+				}
+			}
+		}
+
+		std::copy(output.begin(), output.end(), indices.begin());
+	}
+
+	void optimiseOverdraw(std::span<uint32_t> indices, std::span<const float> vertex_data, size_t floats_per_vertex, float threshold)
+	{
+		const size_t vertex_count = vertex_data.size() / floats_per_vertex;
+		if (indices.size() < 3) {
+			return;
+		}
+
+		// the splits only estimate what they cost, so the result is measured. Clusters that cost too much are
+		// made coarser, and if even those do, the cache order is kept.
+		constexpr size_t max_attempts = 4;
+		const float max_acmr = threshold * analyseVertexCache(indices, vertex_count).acmr;
+		float slack = threshold - 1.0f;
+		for (size_t attempt = 0; attempt < max_attempts; ++attempt, slack *= 0.5f) {
+			const std::vector<uint32_t> output = orderClustersByFacing(indices, vertex_data, floats_per_vertex, 1.0f + slack);
+			if (analyseVertexCache(output, vertex_count).acmr <= max_acmr) {
+				std::copy(output.begin(), output.end(), indices.begin());
+				return;
+			}
+		}
+	}
+
+	void optimiseVertexFetch(std::span<uint32_t> indices, std::span<float> vertex_data, size_t floats_per_vertex)
+	{
+		const size_t vertex_count = vertex_data.size() / floats_per_vertex;
+		std::vector<uint32_t> remap(vertex_count, invalid_index);
+		std::vector<float> reordered(vertex_data.size());
+
+		uint32_t next_vertex = 0;
+		for (uint32_t& index : indices) {
+			if (remap[index] == invalid_index) {
+				remap[index] = next_vertex;
+				std::copy_n(vertex_data.begin() + index * floats_per_vertex, floats_per_vertex, reordered.begin() + next_vertex * floats_per_vertex);
+				++next_vertex;
+			}
+			index = remap[index];
+		}
+		// vertices no index uses keep their data, after all the used ones.
+		for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+			if (remap[vertex] == invalid_index) {
+				std::copy_n(vertex_data.begin() + vertex * floats_per_vertex, floats_per_vertex, reordered.begin() + next_vertex * floats_per_vertex);
+				++next_vertex;
+			}
+		}
+		std::copy(reordered.begin(), reordered.end(), vertex_data.begin());
+	}
+}
@@ -0,0 +1,301 @@
+#include "renderer/3d/MeshSimplifier.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+namespace {
+	// Sum of squared distances to a set of area weighted planes, as the symmetric 4x4 matrix of Garland and Heckbert.
+	struct Quadric {
+		double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+		double a11 = 0, a12 = 0, a13 = 0;
+		double a22 = 0, a23 = 0;
+		double a33 = 0;
+		double weight = 0;
+
+		static auto fromPlane(glm::dvec3 normal, double distance, double weight) -> Quadric
+		{
+			Quadric q;
+			q.a00 = weight * normal.x * normal.x;
+			q.a01 = weight * normal.x * normal.y;
+			q.a02 = weight * normal.x * normal.z;
+			q.a03 = weight * normal.x * distance;
+			q.a11 = weight * normal.y * normal.y;
+			q.a12 = weight * normal.y * normal.z;
+			q.a13 = weight * normal.y * distance;
+			q.a22 = weight * normal.z * normal.z;
+			q.a23 = weight * normal.z * distance;
+			q.a33 = weight * distance * distance;
+			q.weight = weight;
+			return q;
+		}
+
+		auto operator+=(const Quadric& other) -> Quadric&
+		{
+			a00 += other.a00; a01 += other.a01; a02 += other.a02; a03 += other.a03;
+			a11 += other.a11; a12 += other.a12; a13 += other.a13;
+			a22 += other.a22; a23 += other.a23;
+			a33 += other.a33;
+			weight += other.weight;
+			return *this;
+		}
+
+		// the weighted mean squared distance of p to the planes.
+		auto meanError(glm::dvec3 p) const -> double
+		{
+			if (weight == 0) {
+				return 0;
+			}
+			const double error = a00 * p.x * p.x + 2 * a01 * p.x * p.y + 2 * a02 * p.x * p.z + 2 * a03 * p.x
+				+ a11 * p.y * p.y + 2 * a12 * p.y * p.z + 2 * a13 * p.y
+				+ a22 * p.z * p.z + 2 * a23 * p.z
+				+ a33;
+			return std::max(error, 0.0) / weight;
+		}
+	};
+
+	struct Collapse {
+		uint32_t from;
+		uint32_t to;
+		double cost;
+	};
+
+	// how much a difference in attributes counts against a collapse, relative to the squared surface distance.
+	constexpr double attribute_weight = 1e-3;
+
+	struct PositionHash {
+		auto operator()(const glm::vec3& p) const noexcept -> size_t
+		{
+			uint64_t h = std::bit_cast<uint32_t>(p.x);
+			h = (h * 0x9E3779B97F4A7C15ull) ^ std::bit_cast<uint32_t>(p.y);
+			h = (h * 0x9E3779B97F4A7C15ull) ^ std::bit_cast<uint32_t>(p.z);
+			return static_cast<size_t>(h ^ (h >> 32));
+		}
+	};
+}
+
+namespace MeshSimplifier {
+	auto buildLodChain(std::span<const uint32_t> indices, std::span<const float> vertex_data, size_t floats_per_vertex,
+		std::span<const float> ratios, float max_error) -> std::vector<std::vector<uint32_t>>
+	{
+		std::vector<std::vector<uint32_t>> lods;
+		const size_t vertex_count = vertex_data.size() / floats_per_vertex;
+		const size_t triangle_count = indices.size() / 3;
+		if (triangle_count < min_triangle_count || vertex_count == 0) {
+			return lods;
+		}
+
+		// work in a space where the mesh's largest dimension is 1, so errors are relative to the mesh's size.
+		glm::vec3 bounds_min = { vertex_data[0], vertex_data[1], vertex_data[2] };
+		glm::vec3 bounds_max = bounds_min;
+		for (size_t v = 0; v < vertex_count; ++v) {
+			const glm::vec3 p = { vertex_data[v * floats_per_vertex + 0], vertex_data[v * floats_per_vertex + 1], vertex_data[v * floats_per_vertex + 2] };
+			bounds_min = glm::min(bounds_min, p);
+			bounds_max = glm::max(bounds_max, p);
+		}
+		const glm::vec3 extent = bounds_max - bounds_min;
+		const double scale = 1.0 / std::max({ static_cast<double>(extent.x), static_cast<double>(extent.y), static_cast<double>(extent.z), 1e-20 });
+
+		std::vector<glm::dvec3> positions(vertex_count);
+		for (size_t v = 0; v < vertex_count; ++v) {
+			const float* p = vertex_data.data() + v * floats_per_vertex;
+			positions[v] = (glm::dvec3{ p[0], p[1], p[2] } - glm::dvec3{ bounds_min }) * scale;
+		}
+
+		// vertices sharing a position differ in their attributes, a seam that has to stay where it is.
+		std::vector<uint32_t> position_ids(vertex_count);
+		std::vector<bool> is_locked(vertex_count, false);
+		{
+			std::unordered_map<glm::vec3, uint32_t, PositionHash> first_with_position;
+			std::vector<uint32_t> sharing_count(vertex_count, 0);
+			for (size_t v = 0; v < vertex_count; ++v) {
+				const float* p = vertex_data.data() + v * floats_per_vertex;
+				auto [it, is_new] = first_with_position.try_emplace(glm::vec3{ p[0], p[1], p[2] }, static_cast<uint32_t>(v));
+				position_ids[v] = it->second;
+				++sharing_count[it->second];
+			}
+			for (size_t v = 0; v < vertex_count; ++v) {
+				is_locked[v] = sharing_count[position_ids[v]] > 1;
+			}
+
+			// an edge (by position) used by anything other than two triangles is on a border or non manifold.
+			std::unordered_map<uint64_t, uint32_t> edge_uses;
+			auto edgeKey = [&](uint32_t a, uint32_t b) {
+				a = position_ids[a];
+				b = position_ids[b];
+				return (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+			};
+			for (size_t i = 0; i < triangle_count * 3; i += 3) {
+				for (size_t e = 0; e < 3; ++e) {
+					++edge_uses[edgeKey(indices[i + e], indices[i + (e + 1) % 3])];
+				}
+			}
+			for (size_t i = 0; i < triangle_count * 3; i += 3) {
+				for (size_t e = 0; e < 3; ++e) {
+					const uint32_t a = indices[i + e];
+					const uint32_t b = indices[i + (e + 1) % 3];
+					if (edge_uses[edgeKey(a, b)] != 2) {
+						is_locked[a] = true;
+						is_locked[b] = true;
+					}
+				}
+			}
+		}
+
+		std::vector<Quadric> quadrics(vertex_count);
+		for (size_t i = 0; i < triangle_count * 3; i += 3) {
+			const glm::dvec3& a = positions[indices[i + 0]];
+			const glm::dvec3& b = positions[indices[i + 1]];
+			const glm::dvec3& c = positions[indices[i + 2]];
+			glm::dvec3 normal = glm::cross(b - a, c - a);
+			const double double_area = glm::length(normal);
+			if (double_area == 0) {
+				continue;
+			}
+			normal /= double_area;
+			const Quadric plane = Quadric::fromPlane(normal, -glm::dot(normal, a), double_area * 0.5);
+			for (size_t corner = 0; corner < 3; ++corner) {
+				quadrics[indices[i + corner]] += plane;
+			}
+		}
+
+		auto attributeDistance = [&](uint32_t a, uint32_t b) {
+			double distance = 0;
+			for (size_t k = 3; k < floats_per_vertex; ++k) {
+				const double d = vertex_data[a * floats_per_vertex + k] - vertex_data[b * floats_per_vertex + k];
+				distance += d * d;
+			}
+			return distance;
+		};
+		auto collapseCost = [&](uint32_t from, uint32_t to) {
+			return quadrics[from].meanError(positions[to]) + attribute_weight * attributeDistance(from, to);
+		};
+		const double max_cost = static_cast<double>(max_error) * max_error;
+
+		std::vector<uint32_t> current(indices.begin(), indices.end());
+		std::vector<uint32_t> adjacency_offsets(vertex_count + 1);
+		std::vector<uint32_t> adjacency;
+		std::vector<Collapse> collapses;
+		std::vector<bool> is_collapse_locked(vertex_count);
+		std::vector<uint32_t> remap(vertex_count);
+
+		for (float ratio : ratios) {
+			const size_t target_index_count = static_cast<size_t>(triangle_count * ratio) * 3;
+
+			while (current.size() > target_index_count) {
+				// the triangles around each vertex, packed one vertex after another.
+				std::fill(adjacency_offsets.begin(), adjacency_offsets.end(), 0);
+				for (uint32_t index : current) {
+					++adjacency_offsets[index + 1];
+				}
+				std::partial_sum(adjacency_offsets.begin(), adjacency_offsets.end(), adjacency_offsets.begin());
+				adjacency.resize(current.size());
+				{
+					std::vector<uint32_t> fill(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+					for (size_t i = 0; i < current.size(); ++i) {
+						adjacency[fill[current[i]]++] = static_cast<uint32_t>(i / 3);
+					}
+				}
+
+				// every edge once, collapsing whichever way round is cheaper.
+				collapses.clear();
+				for (size_t i = 0; i < current.size(); i += 3) {
+					for (size_t e = 0; e < 3; ++e) {
+						const uint32_t a = current[i + e];
+						const uint32_t b = current[i + (e + 1) % 3];
+						if (a > b && !is_locked[a] && !is_locked[b]) {
+							// interior edges are seen from both of their triangles, only take them once.
+							continue;
+						}
+						const double cost_ab = is_locked[a] ? std::numeric_limits<double>::infinity() : collapseCost(a, b);
+						const double cost_ba = is_locked[b] ? std::numeric_limits<double>::infinity() : collapseCost(b, a);
+						const Collapse collapse = (cost_ab <= cost_ba) ? Collapse{ a, b, cost_ab } : Collapse{ b, a, cost_ba };
+						if (collapse.cost <= max_cost) {
+							collapses.emplace_back(collapse);
+						}
+					}
+				}
+				std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) { return lhs.cost < rhs.cost; });
+
+				// collapses that touch each other's triangles can't be judged independently, so only the cheapest of
+				// those happen in this pass.
+				std::fill(is_collapse_locked.begin(), is_collapse_locked.end(), false);
+				std::iota(remap.begin(), remap.end(), 0u);
+				const size_t triangles_to_remove = (current.size() - target_index_count) / 3;
+				size_t triangles_removed = 0;
+				size_t collapse_count = 0;
+
+				for (const Collapse& collapse : collapses) {
+					if (triangles_removed >= triangles_to_remove) {
+						break;
+					}
+					if (is_collapse_locked[collapse.from] || is_collapse_locked[collapse.to]) {
+						continue;
+					}
+
+					// moving the vertex must not flip any of the triangles that survive the collapse.
+					const uint32_t* around_begin = adjacency.data() + adjacency_offsets[collapse.from];
+					const uint32_t* around_end = adjacency.data() + adjacency_offsets[collapse.from + 1];
+					bool flips = false;
+					size_t removes = 0;
+					for (const uint32_t* triangle = around_begin; triangle != around_end && !flips; ++triangle) {
+						const uint32_t* corners = current.data() + *triangle * 3;
+						if (corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to) {
+							++removes;
+							continue;
+						}
+						std::array<glm::dvec3, 3> before = { positions[corners[0]], positions[corners[1]], positions[corners[2]] };
+						std::array<glm::dvec3, 3> after = before;
+						for (size_t corner = 0; corner < 3; ++corner) {
+							if (corners[corner] == collapse.from) {
+								after[corner] = positions[collapse.to];
+							}
+						}
+						const glm::dvec3 normal_before = glm::cross(before[1] - before[0], before[2] - before[0]);
+						const glm::dvec3 normal_after = glm::cross(after[1] - after[0], after[2] - after[0]);
+						flips = glm::dot(normal_before, normal_after) <= 0.25 * glm::length(normal_before) * glm::length(normal_after);
+					}
+					if (flips) {
+						continue;
+					}
+
+					remap[collapse.from] = collapse.to;
+					quadrics[collapse.to] += quadrics[collapse.from];
+					for (const uint32_t* triangle = around_begin; triangle != around_end; ++triangle) {
+						for (size_t corner = 0; corner < 3; ++corner) {
+							is_collapse_locked[current[*triangle * 3 + corner]] = true;
+						}
+					}
+					triangles_removed += removes;
+					++collapse_count;
+				}
+
+				if (collapse_count == 0) {
+					// nothing left that can be collapsed within the error, the chain ends here.
+					return lods;
+				}
+
+				size_t write = 0;
+				for (size_t i = 0; i < current.size(); i += 3) {
+					const uint32_t a = remap[current[i + 0]];
+					const uint32_t b = remap[current[i + 1]];
+					const uint32_t c = remap[current[i + 2]];
+					if (a != b && b != c && c != a) {
+						current[write++] = a;
+						current[write++] = b;
+						current[write++] = c;
+					}
+				}
+				current.resize(write);
+			}
+			lods.emplace_back(current);
+		}
+		return lods;
+	}
+}
@@ -0,0 +1,230 @@
+#include "renderer/3d/Meshlets.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace {
+	auto positionOf(std::span<const float> vertex_data, size_t floats_per_vertex, uint32_t vertex) -> glm::vec3
+	{
+		const float* p = vertex_data.data() + vertex * floats_per_vertex;
+		return { p[0], p[1], p[2] };
+	}
+
+	void computeBounds(Meshlet& meshlet, std::span<const uint32_t> indices, std::span<const float> vertex_data, size_t floats_per_vertex)
+	{
+		const auto triangles = indices.subspan(meshlet.index_offset, meshlet.index_count);
+
+		glm::vec3 bounds_min = positionOf(vertex_data, floats_per_vertex, triangles[0]);
+		glm::vec3 bounds_max = bounds_min;
+		for (uint32_t index : triangles) {
+			const glm::vec3 p = positionOf(vertex_data, floats_per_vertex, index);
+			bounds_min = glm::min(bounds_min, p);
+			bounds_max = glm::max(bounds_max, p);
+		}
+		meshlet.centre = (bounds_min + bounds_max) * 0.5f;
+		meshlet.radius = 0.0f;
+		for (uint32_t index : triangles) {
+			meshlet.radius = std::max(meshlet.radius, glm::length(positionOf(vertex_data, floats_per_vertex, index) - meshlet.centre));
+		}
+
+		// the cone around the average of the unit face normals, as wide as the normal furthest from it.
+		std::vector<glm::vec3> normals;
+		normals.reserve(triangles.size() / 3);
+		glm::vec3 normal_sum = { 0, 0, 0 };
+		for (size_t i = 0; i < triangles.size(); i += 3) {
+			const glm::vec3 a = positionOf(vertex_data, floats_per_vertex, triangles[i + 0]);
+			const glm::vec3 b = positionOf(vertex_data, floats_per_vertex, triangles[i + 1]);
+			const glm::vec3 c = positionOf(vertex_data, floats_per_vertex, triangles[i + 2]);
+			const glm::vec3 normal = glm::cross(b - a, c - a);
+			const float length = glm::length(normal);
+			if (length > 0.0f) {
+				normals.emplace_back(normal / length);
+				normal_sum += normals.back();
+			}
+		}
+
+		meshlet.cone_axis = { 0, 0, 0 };
+		meshlet.cone_cutoff = 1.0f;
+		const float sum_length = glm::length(normal_sum);
+		if (normals.empty() || sum_length == 0.0f) {
+			return;
+		}
+		const glm::vec3 axis = normal_sum / sum_length;
+		float min_dot = 1.0f;
+		for (const glm::vec3& normal : normals) {
+			min_dot = std::min(min_dot, glm::dot(normal, axis));
+		}
+		if (min_dot <= 0.0f) {
+			// wider than a hemisphere, some triangle faces every viewer.
+			return;
+		}
+		meshlet.cone_axis = axis;
+		meshlet.cone_cutoff = std::sqrt(1.0f - min_dot * min_dot);
+	}
+}
+
+namespace Meshlets {
+	auto build(std::span<uint32_t> indices, std::span<const float> vertex_data, size_t floats_per_vertex) -> std::vector<Meshlet>
+	{
+		std::vector<Meshlet> meshlets;
+		const size_t triangle_count = indices.size() / 3;
+		const size_t vertex_count = vertex_data.size() / floats_per_vertex;
+		if (triangle_count == 0) {
+			return meshlets;
+		}
+
+		std::vector<glm::vec3> normals(triangle_count);
+		for (size_t t = 0; t < triangle_count; ++t) {
+			const glm::vec3 a = positionOf(vertex_data, floats_per_vertex, indices[t * 3 + 0]);
+			const glm::vec3 b = positionOf(vertex_data, floats_per_vertex, indices[t * 3 + 1]);
+			const glm::vec3 c = positionOf(vertex_data, floats_per_vertex, indices[t * 3 + 2]);
+			const glm::vec3 normal = glm::cross(b - a, c - a);
+			const float length = glm::length(normal);
+			normals[t] = (length > 0.0f) ? normal / length : glm::vec3{ 0, 0, 0 };
+		}
+
+		// the triangles around each vertex, packed one vertex after another.
+		std::vector<uint32_t> adjacency_offsets(vertex_count + 1, 0);
+		for (uint32_t index : indices) {
+			++adjacency_offsets[index + 1];
+		}
+		std::partial_sum(adjacency_offsets.begin(), adjacency_offsets.end(), adjacency_offsets.begin());
+		std::vector<uint32_t> adjacency(indices.size());
+		{
+			std::vector<uint32_t> fill(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); ++i) {
+				adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		// the meshlet each vertex was last added to, so a meshlet's vertices can be counted without clearing a set.
+		std::vector<uint32_t> vertex_meshlet(vertex_count, std::numeric_limits<uint32_t>::max());
+		std::vector<bool> is_emitted(triangle_count, false);
+		// the meshlet each triangle was last made a candidate of, so the candidates hold no duplicates.
+		std::vector<uint32_t> candidate_of(triangle_count, std::numeric_limits<uint32_t>::max());
+		std::vector<uint32_t> order;
+		order.reserve(triangle_count);
+		std::vector<uint32_t> candidates;
+
+		size_t next_seed = 0;
+		while (order.size() < triangle_count) {
+			while (is_emitted[next_seed]) {
+				++next_seed;
+			}
+			const auto meshlet_id = static_cast<uint32_t>(meshlets.size());
+			Meshlet& meshlet = meshlets.emplace_back();
+			meshlet.index_offset = static_cast<uint32_t>(order.size() * 3);
+
+			size_t vertices_used = 0;
+			glm::vec3 normal_sum = { 0, 0, 0 };
+			candidates.clear();
+
+			auto countNewVertices = [&](uint32_t triangle) {
+				const uint32_t* corners = indices.data() + triangle * 3;
+				size_t new_vertices = (vertex_meshlet[corners[0]] != meshlet_id) ? 1 : 0;
+				new_vertices += (corners[1] != corners[0] && vertex_meshlet[corners[1]] != meshlet_id) ? 1 : 0;
+				new_vertices += (corners[2] != corners[0] && corners[2] != corners[1] && vertex_meshlet[corners[2]] != meshlet_id) ? 1 : 0;
+				return new_vertices;
+			};
+			auto emit = [&](uint32_t triangle) {
+				vertices_used += countNewVertices(triangle);
+				for (size_t corner = 0; corner < 3; ++corner) {
+					const uint32_t vertex = indices[triangle * 3 + corner];
+					vertex_meshlet[vertex] = meshlet_id;
+					for (uint32_t k = adjacency_offsets[vertex]; k < adjacency_offsets[vertex + 1]; ++k) {
+						const uint32_t neighbour = adjacency[k];
+						if (!is_emitted[neighbour] && candidate_of[neighbour] != meshlet_id) {
+							candidate_of[neighbour] = meshlet_id;
+							candidates.emplace_back(neighbour);
+						}
+					}
+				}
+				is_emitted[triangle] = true;
+				normal_sum += normals[triangle];
+				order.emplace_back(triangle);
+				meshlet.index_count += 3;
+			};
+
+			// grow from the seed across neighbouring triangles, preferring ones that reuse the meshlet's vertices
+			// and face the same way as it, until it is full or everything around it bends away.
+			emit(static_cast<uint32_t>(next_seed));
+			while (meshlet.index_count / 3 < max_triangles) {
+				const float normal_sum_length = glm::length(normal_sum);
+				const glm::vec3 axis = (normal_sum_length > 0.0f) ? normal_sum / normal_sum_length : glm::vec3{ 0, 0, 0 };
+
+				uint32_t best = std::numeric_limits<uint32_t>::max();
+				float best_score = std::numeric_limits<float>::max();
+				size_t kept = 0;
+				for (uint32_t candidate : candidates) {
+					if (is_emitted[candidate]) {
+						continue;
+					}
+					candidates[kept++] = candidate;
+					const size_t new_vertices = countNewVertices(candidate);
+					const float alignment = glm::dot(normals[candidate], axis);
+					if (vertices_used + new_vertices > max_vertices || (normal_sum_length > 0.0f && alignment < max_normal_deviation)) {
+						continue;
+					}
+					const float score = static_cast<float>(new_vertices) + (1.0f - alignment) * normal_weight;
+					if (score < best_score) {
+						best_score = score;
+						best = candidate;
+					}
+				}
+				candidates.resize(kept);
+				if (best == std::numeric_limits<uint32_t>::max()) {
+					break;
+				}
+				emit(best);
+			}
+		}
+
+		std::vector<uint32_t> reordered(indices.size());
+		for (size_t i = 0; i < order.size(); ++i) {
+			std::copy_n(indices.begin() + order[i] * 3, 3, reordered.begin() + i * 3);
+		}
+		std::ranges::copy(reordered, indices.begin());
+
+		for (Meshlet& meshlet : meshlets) {
+			computeBounds(meshlet, indices, vertex_data, floats_per_vertex);
+		}
+		return meshlets;
+	}
+
+	auto cullingViewOf(const glm::mat4& model_view, const glm::mat4& projection) noexcept -> CullingView
+	{
+		CullingView view;
+
+		// Gribb and Hartmann, the planes are sums and differences of the rows of the combined matrix.
+		const glm::mat4 m = projection * model_view;
+		auto row = [&](int r) { return glm::vec4{ m[0][r], m[1][r], m[2][r], m[3][r] }; };
+		view.planes = {
+			row(3) + row(0),
+			row(3) - row(0),
+			row(3) + row(1),
+			row(3) - row(1),
+			row(3) + row(2),
+			row(3) - row(2)
+		};
+		for (glm::vec4& plane : view.planes) {
+			plane /= glm::length(glm::vec3(plane));
+		}
+
+		const glm::vec4 camera = glm::inverse(model_view) * glm::vec4{ 0, 0, 0, 1 };
+		view.camera_position = glm::vec3(camera) / camera.w;
+		return view;
+	}
+
+	auto isVisible(const Meshlet& meshlet, const CullingView& view) noexcept -> bool
+	{
+		for (const glm::vec4& plane : view.planes) {
+			if (glm::dot(glm::vec3(plane), meshlet.centre) + plane.w < -meshlet.radius) {
+				return false;
+			}
+		}
+		const glm::vec3 to_centre = meshlet.centre - view.camera_position;
+		return glm::dot(to_centre, meshlet.cone_axis) < meshlet.cone_cutoff * glm::length(to_centre) + meshlet.radius;
+	}
+}
@@ -0,0 +1,139 @@
+#include "renderer/3d/VertexQuantisation.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace VertexQuantisation {
+	auto toHalf(float value) noexcept -> HalfFloat
+	{
+		const uint32_t bits = std::bit_cast<uint32_t>(value);
+		const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+		const uint32_t magnitude = bits & 0x7FFFFFFF;
+
+		if (magnitude >= 0x7F800000) {
+			// infinity stays infinity, nan stays a (quiet) nan.
+			return { static_cast<uint16_t>(sign | 0x7C00 | ((magnitude > 0x7F800000) ? 0x0200 : 0)) };
+		}
+		if (magnitude >= 0x477FF000) {
+			// 65520 and above round past the largest half, 65504.
+			return { static_cast<uint16_t>(sign | 0x7C00) };
+		}
+		if (magnitude < 0x38800000) {
+			// below the smallest normal half, 2^-14, the half's bits are just the value in units of 2^-24.
+			const float units = std::bit_cast<float>(magnitude) * 16777216.0f;
+			return { static_cast<uint16_t>(sign | static_cast<uint16_t>(std::nearbyint(units))) };
+		}
+
+		// rebias the exponent from 127 to 15 and drop 13 mantissa bits, rounding to nearest even.
+		uint32_t half = (magnitude - 0x38000000) >> 13;
+		const uint32_t remainder = magnitude & 0x1FFF;
+		if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+			++half;
+		}
+		return { static_cast<uint16_t>(sign | half) };
+	}
+
+	auto fromHalf(HalfFloat value) noexcept -> float
+	{
+		const uint32_t sign = static_cast<uint32_t>(value.bits & 0x8000) << 16;
+		const uint32_t exponent = (value.bits >> 10) & 0x1F;
+		const uint32_t mantissa = value.bits & 0x3FF;
+
+		if (exponent == 0) {
+			const float magnitude = static_cast<float>(mantissa) / 16777216.0f;
+			return std::bit_cast<float>(sign | std::bit_cast<uint32_t>(magnitude));
+		}
+		if (exponent == 0x1F) {
+			return std::bit_cast<float>(sign | 0x7F800000 | (mantissa << 13));
+		}
+		return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+	}
+
+	auto toSnorm16(float value) noexcept -> int16_t
+	{
+		return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+	}
+
+	auto fromSnorm16(int16_t value) noexcept -> float
+	{
+		// the gles 3 / gl 4.2 conversion, which is what the shader sees for normalised GL_SHORT attributes.
+		return std::max(static_cast<float>(value) / 32767.0f, -1.0f);
+	}
+
+	auto encodeOctahedral(glm::vec3 normal) noexcept -> glm::vec2
+	{
+		const float l1_norm = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+		if (l1_norm == 0.0f) {
+			return { 0.0f, 0.0f };
+		}
+		normal /= l1_norm;
+
+		glm::vec2 encoded = { normal.x, normal.y };
+		if (normal.z < 0.0f) {
+			// fold the lower hemisphere over the diagonals of the square.
+			encoded.x = (1.0f - std::abs(normal.y)) * ((normal.x >= 0.0f) ? 1.0f : -1.0f);
+			encoded.y = (1.0f - std::abs(normal.x)) * ((normal.y >= 0.0f) ? 1.0f : -1.0f);
+		}
+		return encoded;
+	}
+
+	auto decodeOctahedral(glm::vec2 encoded) noexcept -> glm::vec3
+	{
+		// matches vertexNormal() in assets/shaders/common/vertex_attributes.glsl.
+		glm::vec3 normal = { encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y) };
+		const float fold = std::max(-normal.z, 0.0f);
+		normal.x += (normal.x >= 0.0f) ? -fold : fold;
+		normal.y += (normal.y >= 0.0f) ? -fold : fold;
+		return glm::normalize(normal);
+	}
+
+	template <MeshType Type>
+	auto quantise(const Mesh<Type>& mesh) -> QuantisedMesh<Type>
+	{
+		constexpr size_t stride = Mesh<Type>::floats_per_vertex_attribute;
+		const size_t vertex_count = mesh.vertex_buffer_data.size() / stride;
+
+		const glm::vec3 centre = (mesh.bounds_min + mesh.bounds_max) * 0.5f;
+		const glm::vec3 half_extent = (mesh.bounds_max - mesh.bounds_min) * 0.5f;
+		float scale = std::max({ half_extent.x, half_extent.y, half_extent.z });
+		if (!(scale > 0.0f)) {
+			scale = 1.0f;
+		}
+		const float inverse_scale = 1.0f / scale;
+
+		QuantisedMesh<Type> quantised;
+		quantised.positions.resize(vertex_count);
+		if constexpr (hasNormals(Type)) {
+			quantised.attributes.resize(vertex_count);
+		}
+		for (size_t i = 0; i < vertex_count; ++i) {
+			const float* vertex = mesh.vertex_buffer_data.data() + i * stride;
+
+			quantised.positions[i] = {
+				toSnorm16((vertex[0] - centre.x) * inverse_scale),
+				toSnorm16((vertex[1] - centre.y) * inverse_scale),
+				toSnorm16((vertex[2] - centre.z) * inverse_scale),
+				0
+			};
+			if constexpr (hasNormals(Type)) {
+				const glm::vec2 normal = encodeOctahedral({ vertex[3], vertex[4], vertex[5] });
+				quantised.attributes[i].normal = { toSnorm16(normal.x), toSnorm16(normal.y) };
+			}
+			if constexpr (hasUvs(Type)) {
+				quantised.attributes[i].uv = { toHalf(vertex[6]), toHalf(vertex[7]) };
+			}
+		}
+
+		quantised.dequantisation = glm::mat4(1.0f);
+		quantised.dequantisation[0][0] = scale;
+		quantised.dequantisation[1][1] = scale;
+		quantised.dequantisation[2][2] = scale;
+		quantised.dequantisation[3] = glm::vec4(centre, 1.0f);
+		return quantised;
+	}
+
+	template auto quantise(const Mesh<MeshType::positions_only>& mesh) -> QuantisedMesh<MeshType::positions_only>;
+	template auto quantise(const Mesh<MeshType::positions_and_normals>& mesh) -> QuantisedMesh<MeshType::positions_and_normals>;
+	template auto quantise(const Mesh<MeshType::positions_normals_uvs>& mesh) -> QuantisedMesh<MeshType::positions_normals_uvs>;
+}
@@ -0,0 +1,61 @@
+#include "renderer/RenderQueue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace {
+	constexpr auto maskTo(uint32_t value, uint32_t bits) noexcept -> uint64_t
+	{
+		return std::min<uint64_t>(value, (uint64_t{ 1 } << bits) - 1);
+	}
+}
+
+auto RenderQueue::quantiseDepth(float view_depth) noexcept -> uint32_t
+{
+	// behind the camera and nan both count as right at it.
+	const float depth = (view_depth > 0.0f) ? view_depth : 0.0f;
+	return std::bit_cast<uint32_t>(depth) >> (32 - depth_bits);
+}
+
+auto RenderQueue::makeKey(Pass pass, uint32_t shader, uint32_t texture, uint32_t mesh, uint32_t depth) noexcept -> uint64_t
+{
+	const uint64_t state = (maskTo(shader, shader_bits) << (texture_bits + mesh_bits))
+		| (maskTo(texture, texture_bits) << mesh_bits)
+		| maskTo(mesh, mesh_bits);
+	const uint64_t pass_key = static_cast<uint64_t>(pass) << (64 - pass_bits);
+
+	if (pass == Pass::opaque) {
+		return pass_key | (state << depth_bits) | maskTo(depth, depth_bits);
+	}
+	const uint64_t inverted_depth = ((uint64_t{ 1 } << depth_bits) - 1) - maskTo(depth, depth_bits);
+	return pass_key | (inverted_depth << (shader_bits + texture_bits + mesh_bits)) | state;
+}
+
+auto RenderQueue::sort() -> void
+{
+	constexpr size_t radix = 256;
+	m_scratch.resize(m_entries.size());
+
+	for (uint32_t shift = 0; shift < 64; shift += 8) {
+		std::array<size_t, radix> counts = {};
+		for (const Entry& entry : m_entries) {
+			++counts[(entry.key >> shift) & (radix - 1)];
+		}
+		// every key has the same byte here, the pass wouldn't move anything.
+		if (std::ranges::any_of(counts, [&](size_t count) { return count == m_entries.size(); })) {
+			continue;
+		}
+
+		size_t offset = 0;
+		for (size_t& count : counts) {
+			const size_t bucket_size = count;
+			count = offset;
+			offset += bucket_size;
+		}
+		for (const Entry& entry : m_entries) {
+			m_scratch[counts[(entry.key >> shift) & (radix - 1)]++] = entry;
+		}
+		m_entries.swap(m_scratch);
+	}
+}
@@ -0,0 +1,83 @@
+#include "renderer/core/BufferAllocator.hpp"
+
+#include "BuildSettings.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+
+auto BufferAllocator::init(uint32_t capacity) -> void
+{
+	m_capacity = capacity;
+	m_free_size = 0;
+	m_free_by_offset.clear();
+	m_free_by_size.clear();
+	if (capacity != 0) {
+		addFreeBlock(0, capacity);
+	}
+}
+
+auto BufferAllocator::allocate(uint32_t size) -> std::optional<Range>
+{
+	if (size == 0) {
+		return Range{ 0, 0 };
+	}
+
+	auto best_fit = m_free_by_size.lower_bound({ size, 0 });
+	if (best_fit == m_free_by_size.end()) {
+		return std::nullopt;
+	}
+	const auto [block_size, block_offset] = *best_fit;
+	removeFreeBlock(m_free_by_offset.find(block_offset));
+	if (block_size != size) {
+		addFreeBlock(block_offset + size, block_size - size);
+	}
+	return Range{ block_offset, size };
+}
+
+auto BufferAllocator::free(Range range) -> void
+{
+	if (range.size == 0) {
+		return;
+	}
+	if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+		auto next = m_free_by_offset.lower_bound(range.offset);
+		const bool overlaps_next = next != m_free_by_offset.end() && next->first < range.offset + range.size;
+		const bool overlaps_previous = next != m_free_by_offset.begin() && std::prev(next)->first + std::prev(next)->second > range.offset;
+		if (range.offset + range.size > m_capacity || overlaps_next || overlaps_previous) {
+			std::cerr << "BufferAllocator failed, trying to \"free\" a range that isn't allocated.\n";
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	uint32_t offset = range.offset;
+	uint32_t size = range.size;
+	auto next = m_free_by_offset.lower_bound(offset);
+	if (next != m_free_by_offset.begin()) {
+		auto previous = std::prev(next);
+		if (previous->first + previous->second == offset) {
+			offset = previous->first;
+			size += previous->second;
+			removeFreeBlock(previous);
+		}
+	}
+	if (next != m_free_by_offset.end() && next->first == range.offset + range.size) {
+		size += next->second;
+		removeFreeBlock(next);
+	}
+	addFreeBlock(offset, size);
+}
+
+auto BufferAllocator::addFreeBlock(uint32_t offset, uint32_t size) -> void
+{
+	m_free_by_offset.emplace(offset, size);
+	m_free_by_size.emplace(size, offset);
+	m_free_size += size;
+}
+
+auto BufferAllocator::removeFreeBlock(std::map<uint32_t, uint32_t>::iterator block) -> void
+{
+	m_free_by_size.erase({ block->second, block->first });
+	m_free_size -= block->second;
+	m_free_by_offset.erase(block);
+}
@@ -0,0 +1,282 @@
+#include "renderer/core/GlState.hpp"
+
+#include <array>
+#include <optional>
+
+namespace GlState {
+	namespace {
+		// nullopt is unknown, the next call reaches GL whatever it sets.
+		template <typename T>
+		using Cached = std::optional<T>;
+
+		constexpr size_t max_texture_units = 32;
+		// GL 3.3 and WebGL2 both guarantee at least 24 combined uniform buffer bindings.
+		constexpr size_t max_uniform_bindings = 24;
+
+		enum BufferSlot : size_t {
+			array_buffer,
+			element_array_buffer,
+			copy_read_buffer,
+			copy_write_buffer,
+			draw_indirect_buffer,
+			uniform_buffer,
+			buffer_slot_count,
+		};
+
+		struct State {
+			Cached<uint32_t> program;
+			Cached<uint32_t> vertex_array;
+			std::array<Cached<uint32_t>, buffer_slot_count> buffers;
+			// buffer, offset and size bound to each uniform block binding point.
+			std::array<Cached<std::array<size_t, 3>>, max_uniform_bindings> uniform_ranges;
+			Cached<uint32_t> active_texture_unit;
+			std::array<Cached<uint32_t>, max_texture_units> textures_2d;
+			Cached<uint32_t> draw_framebuffer;
+			Cached<uint32_t> read_framebuffer;
+			Cached<std::array<int32_t, 4>> viewport;
+			Cached<bool> blend;
+			Cached<bool> depth_test;
+			Cached<bool> cull_face;
+			Cached<std::array<uint32_t, 2>> blend_func;
+			Cached<uint32_t> depth_func;
+			Cached<bool> depth_mask;
+			Cached<uint32_t> cull_face_mode;
+		};
+
+		State state;
+		Stats stats;
+
+		// updates cached and returns true when value differs from it, so the caller should reach GL.
+		template <typename T>
+		auto change(Cached<T>& cached, const T& value) noexcept -> bool
+		{
+			if (cached == value) {
+				++stats.skipped;
+				return false;
+			}
+			cached = value;
+			++stats.issued;
+			return true;
+		}
+
+		auto getBufferSlot(uint32_t target) noexcept -> std::optional<BufferSlot>
+		{
+			switch (target) {
+			case GL_ARRAY_BUFFER: return array_buffer;
+			case GL_ELEMENT_ARRAY_BUFFER: return element_array_buffer;
+			case GL_COPY_READ_BUFFER: return copy_read_buffer;
+			case GL_COPY_WRITE_BUFFER: return copy_write_buffer;
+#if BUILD_TARGET == NATIVE_BUILD
+			case GL_DRAW_INDIRECT_BUFFER: return draw_indirect_buffer;
+#endif
+			case GL_UNIFORM_BUFFER: return uniform_buffer;
+			default: return std::nullopt;
+			}
+		}
+
+		auto getCapability(uint32_t capability) noexcept -> Cached<bool>*
+		{
+			switch (capability) {
+			case GL_BLEND: return &state.blend;
+			case GL_DEPTH_TEST: return &state.depth_test;
+			case GL_CULL_FACE: return &state.cull_face;
+			default: return nullptr;
+			}
+		}
+
+		template <typename T>
+		auto forget(Cached<T>& cached, const T& name) noexcept -> void
+		{
+			if (cached == name) {
+				cached = T{ 0 };
+			}
+		}
+	}
+
+	auto getStats() noexcept -> const Stats&
+	{
+		return stats;
+	}
+
+	auto resetStats() noexcept -> void
+	{
+		stats = {};
+	}
+
+	auto invalidate() noexcept -> void
+	{
+		state = {};
+	}
+
+	auto useProgram(uint32_t program) noexcept -> void
+	{
+		if (change(state.program, program)) {
+			glUseProgram(program);
+		}
+	}
+
+	auto bindVertexArray(uint32_t vertex_array) noexcept -> void
+	{
+		if (change(state.vertex_array, vertex_array)) {
+			glBindVertexArray(vertex_array);
+			state.buffers[element_array_buffer] = std::nullopt;
+		}
+	}
+
+	auto bindBuffer(uint32_t target, uint32_t buffer) noexcept -> void
+	{
+		const auto slot = getBufferSlot(target);
+		if (!slot) {
+			++stats.issued;
+			glBindBuffer(target, buffer);
+			return;
+		}
+		if (change(state.buffers[slot.value()], buffer)) {
+			glBindBuffer(target, buffer);
+		}
+	}
+
+	auto bindBufferRange(uint32_t target, uint32_t index, uint32_t buffer, size_t offset_in_bytes, size_t size_in_bytes) noexcept -> void
+	{
+		// glBindBufferRange binds the generic target as well.
+		if (const auto slot = getBufferSlot(target); slot) {
+			state.buffers[slot.value()] = buffer;
+		}
+		if (target != GL_UNIFORM_BUFFER || index >= max_uniform_bindings) {
+			++stats.issued;
+			glBindBufferRange(target, index, buffer, offset_in_bytes, size_in_bytes);
+			return;
+		}
+		if (change(state.uniform_ranges[index], std::array<size_t, 3>{ buffer, offset_in_bytes, size_in_bytes })) {
+			glBindBufferRange(target, index, buffer, offset_in_bytes, size_in_bytes);
+		}
+	}
+
+	auto activeTexture(uint32_t unit) noexcept -> void
+	{
+		if (change(state.active_texture_unit, unit)) {
+			glActiveTexture(GL_TEXTURE0 + unit);
+		}
+	}
+
+	auto bindTexture(uint32_t target, uint32_t texture) noexcept -> void
+	{
+		if (target != GL_TEXTURE_2D || !state.active_texture_unit || state.active_texture_unit.value() >= max_texture_units) {
+			++stats.issued;
+			glBindTexture(target, texture);
+			return;
+		}
+		if (change(state.textures_2d[state.active_texture_unit.value()], texture)) {
+			glBindTexture(target, texture);
+		}
+	}
+
+	auto bindFramebuffer(uint32_t target, uint32_t framebuffer) noexcept -> void
+	{
+		if (target == GL_FRAMEBUFFER) {
+			if (state.draw_framebuffer == framebuffer && state.read_framebuffer == framebuffer) {
+				++stats.skipped;
+				return;
+			}
+			state.draw_framebuffer = framebuffer;
+			state.read_framebuffer = framebuffer;
+			++stats.issued;
+			glBindFramebuffer(target, framebuffer);
+			return;
+		}
+		auto& cached = (target == GL_DRAW_FRAMEBUFFER) ? state.draw_framebuffer : state.read_framebuffer;
+		if (change(cached, framebuffer)) {
+			glBindFramebuffer(target, framebuffer);
+		}
+	}
+
+	auto viewport(int32_t x, int32_t y, int32_t width, int32_t height) noexcept -> void
+	{
+		if (change(state.viewport, std::array{ x, y, width, height })) {
+			glViewport(x, y, width, height);
+		}
+	}
+
+	auto setEnabled(uint32_t capability, bool is_enabled) noexcept -> void
+	{
+		Cached<bool>* cached = getCapability(capability);
+		if (cached && !change(*cached, is_enabled)) {
+			return;
+		}
+		if (!cached) {
+			++stats.issued;
+		}
+		if (is_enabled) {
+			glEnable(capability);
+		} else {
+			glDisable(capability);
+		}
+	}
+
+	auto blendFunc(uint32_t source_factor, uint32_t destination_factor) noexcept -> void
+	{
+		if (change(state.blend_func, std::array{ source_factor, destination_factor })) {
+			glBlendFunc(source_factor, destination_factor);
+		}
+	}
+
+	auto depthFunc(uint32_t func) noexcept -> void
+	{
+		if (change(state.depth_func, func)) {
+			glDepthFunc(func);
+		}
+	}
+
+	auto depthMask(bool is_writing) noexcept -> void
+	{
+		if (change(state.depth_mask, is_writing)) {
+			glDepthMask(is_writing ? GL_TRUE : GL_FALSE);
+		}
+	}
+
+	auto cullFace(uint32_t mode) noexcept -> void
+	{
+		if (change(state.cull_face_mode, mode)) {
+			glCullFace(mode);
+		}
+	}
+
+	auto forgetProgram(uint32_t program) noexcept -> void
+	{
+		forget(state.program, program);
+	}
+
+	auto forgetVertexArray(uint32_t vertex_array) noexcept -> void
+	{
+		if (state.vertex_array == vertex_array) {
+			// falls back to vertex array 0, whose element array buffer we never tracked.
+			state.vertex_array = 0;
+			state.buffers[element_array_buffer] = std::nullopt;
+		}
+	}
+
+	auto forgetBuffer(uint32_t buffer) noexcept -> void
+	{
+		for (Cached<uint32_t>& cached : state.buffers) {
+			forget(cached, buffer);
+		}
+		for (Cached<std::array<size_t, 3>>& cached : state.uniform_ranges) {
+			if (cached && cached.value()[0] == buffer) {
+				cached = std::nullopt;
+			}
+		}
+	}
+
+	auto forgetTexture(uint32_t texture) noexcept -> void
+	{
+		for (Cached<uint32_t>& cached : state.textures_2d) {
+			forget(cached, texture);
+		}
+	}
+
+	auto forgetFramebuffer(uint32_t framebuffer) noexcept -> void
+	{
+		forget(state.draw_framebuffer, framebuffer);
+		forget(state.read_framebuffer, framebuffer);
+	}
+}
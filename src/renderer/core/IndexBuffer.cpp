@@ -1,4 +1,5 @@
 #include "renderer/core/IndexBuffer.hpp"
+#include "renderer/core/GlState.hpp"
 
 #include "BuildSettings.hpp"
 
@@ -16,12 +17,14 @@ auto IndexBuffer::init() noexcept -> void
 		m_ibo = std::nullopt;
 	}
 	m_index_count = 0;
+	m_index_type = GL_UNSIGNED_INT;
 }
 
 auto IndexBuffer::stop() noexcept -> void
 {
 	if (m_ibo) {
 		this->unbind();
+		GlState::forgetBuffer(m_ibo.value());
 		glDeleteBuffers(1, &m_ibo.value());
 		m_ibo = std::nullopt;
 	}
@@ -35,7 +38,7 @@ auto IndexBuffer::bind() noexcept -> void
 			exit(EXIT_FAILURE);
 		}
 	}
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo.value());
+	GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo.value());
 }
 
 auto IndexBuffer::unbind() noexcept -> void
@@ -46,7 +49,49 @@ auto IndexBuffer::unbind() noexcept -> void
 			exit(EXIT_FAILURE);
 		}
 	}
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+auto IndexBuffer::reserve(uint32_t index_count, uint32_t usage) noexcept -> void
+{
+	if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+		if (!m_ibo) {
+			std::cerr << "IndexBuffer failed, trying to \"reserve\" an unitialised index buffer object.";
+			exit(EXIT_FAILURE);
+		}
+	}
+	this->bind();
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, size_t{ index_count } * sizeof(uint32_t), nullptr, usage);
+	m_index_count = index_count;
+	m_index_type = GL_UNSIGNED_INT;
+}
+
+auto IndexBuffer::loadSubIndices(uint32_t first_index, std::span<const uint32_t> indices) noexcept -> void
+{
+	if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+		if (!m_ibo || m_index_type != GL_UNSIGNED_INT || first_index + indices.size() > m_index_count) {
+			std::cerr << "IndexBuffer failed, trying to \"load sub indices\" outside of a reserved index buffer object.";
+			exit(EXIT_FAILURE);
+		}
+	}
+	this->bind();
+	glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, size_t{ first_index } * sizeof(uint32_t), indices.size_bytes(), indices.data());
+}
+
+auto IndexBuffer::copyFrom(IndexBuffer& source, uint32_t source_first_index, uint32_t first_index, uint32_t index_count) noexcept -> void
+{
+	if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+		if (!m_ibo || !source.m_ibo || m_ibo == source.m_ibo) {
+			std::cerr << "IndexBuffer failed, trying to \"copy\" between unitialised or identical index buffer objects.";
+			exit(EXIT_FAILURE);
+		}
+	}
+	GlState::bindBuffer(GL_COPY_READ_BUFFER, source.m_ibo.value());
+	GlState::bindBuffer(GL_COPY_WRITE_BUFFER, m_ibo.value());
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+		size_t{ source_first_index } * sizeof(uint32_t), size_t{ first_index } * sizeof(uint32_t), size_t{ index_count } * sizeof(uint32_t));
+	GlState::bindBuffer(GL_COPY_READ_BUFFER, 0);
+	GlState::bindBuffer(GL_COPY_WRITE_BUFFER, 0);
 }
 
 IndexBuffer::~IndexBuffer()
@@ -0,0 +1,109 @@
+#include "renderer/core/MultiDraw.hpp"
+
+#include <vector>
+
+#include "renderer/core/GlState.hpp"
+#include "renderer/core/StreamBuffer.hpp"
+
+namespace MultiDraw {
+	namespace {
+		Path path = Path::loop;
+
+		auto getFirstIndexPointer(const DrawElementsIndirectCommand& command, uint32_t index_size) noexcept -> const void*
+		{
+			return reinterpret_cast<const void*>(uintptr_t{ command.first_index } * index_size);
+		}
+
+#if BUILD_TARGET == WEB_BUILD
+		// the extension takes the commands as separate arrays, reused between batches.
+		std::vector<GLsizei> counts;
+		std::vector<const void*> offsets;
+		std::vector<GLsizei> instance_counts;
+		std::vector<GLint> base_vertices;
+		std::vector<GLuint> base_instances;
+#endif
+	}
+
+	auto init() noexcept -> void
+	{
+#if BUILD_TARGET == NATIVE_BUILD
+		if (GLEW_ARB_multi_draw_indirect && GLEW_ARB_base_instance) {
+			path = Path::multi_draw;
+		} else if (GLEW_ARB_base_instance) {
+			path = Path::base_instance_loop;
+		} else {
+			path = Path::loop;
+		}
+#elif BUILD_TARGET == WEB_BUILD
+		// plain WEBGL_multi_draw can't offset instanced attributes per draw, so it's only of use with base instances.
+		const EMSCRIPTEN_WEBGL_CONTEXT_HANDLE context = emscripten_webgl_get_current_context();
+		if (emscripten_webgl_enable_WEBGL_multi_draw_instanced_base_vertex_base_instance(context)) {
+			path = Path::multi_draw;
+		} else if (emscripten_webgl_enable_WEBGL_draw_instanced_base_vertex_base_instance(context)) {
+			path = Path::base_instance_loop;
+		} else {
+			path = Path::loop;
+		}
+#endif
+	}
+
+	auto getPath() noexcept -> Path
+	{
+		return path;
+	}
+
+	auto drawWithBaseInstances(std::span<const DrawElementsIndirectCommand> commands, uint32_t index_type, uint32_t index_size) noexcept -> void
+	{
+		if (commands.empty()) {
+			return;
+		}
+#if BUILD_TARGET == NATIVE_BUILD
+		if (path == Path::multi_draw) {
+			// the commands are read from the frame's stream, bound as the indirect buffer.
+			FrameStream::vertices().push(commands, sizeof(uint32_t))
+				.OnValue([&](StreamSlice& slice) {
+					FrameStream::vertices().getBuffer().bindAs(GL_DRAW_INDIRECT_BUFFER);
+					glMultiDrawElementsIndirect(GL_TRIANGLES, index_type, slice.getPointer(), static_cast<GLsizei>(commands.size()), sizeof(DrawElementsIndirectCommand));
+					GlState::bindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+				});
+			return;
+		}
+		for (const DrawElementsIndirectCommand& command : commands) {
+			glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, command.count, index_type, getFirstIndexPointer(command, index_size),
+				command.instance_count, command.base_vertex, command.base_instance);
+		}
+#elif BUILD_TARGET == WEB_BUILD
+		if (path == Path::multi_draw) {
+			counts.clear();
+			offsets.clear();
+			instance_counts.clear();
+			base_vertices.clear();
+			base_instances.clear();
+			for (const DrawElementsIndirectCommand& command : commands) {
+				counts.push_back(static_cast<GLsizei>(command.count));
+				offsets.push_back(getFirstIndexPointer(command, index_size));
+				instance_counts.push_back(static_cast<GLsizei>(command.instance_count));
+				base_vertices.push_back(command.base_vertex);
+				base_instances.push_back(command.base_instance);
+			}
+			glMultiDrawElementsInstancedBaseVertexBaseInstanceWEBGL(GL_TRIANGLES, counts.data(), index_type, offsets.data(),
+				instance_counts.data(), base_vertices.data(), base_instances.data(), static_cast<GLsizei>(commands.size()));
+			return;
+		}
+		for (const DrawElementsIndirectCommand& command : commands) {
+			glDrawElementsInstancedBaseVertexBaseInstanceWEBGL(GL_TRIANGLES, command.count, index_type, getFirstIndexPointer(command, index_size),
+				command.instance_count, command.base_vertex, command.base_instance);
+		}
+#endif
+	}
+
+	auto drawWithoutBaseInstance(const DrawElementsIndirectCommand& command, uint32_t index_type, uint32_t index_size) noexcept -> void
+	{
+#if BUILD_TARGET == NATIVE_BUILD
+		glDrawElementsInstancedBaseVertex(GL_TRIANGLES, command.count, index_type, getFirstIndexPointer(command, index_size), command.instance_count, command.base_vertex);
+#elif BUILD_TARGET == WEB_BUILD
+		// the indices were offset on upload, see GeometryArena, so base_vertex is always zero.
+		glDrawElementsInstanced(GL_TRIANGLES, command.count, index_type, getFirstIndexPointer(command, index_size), command.instance_count);
+#endif
+	}
+}
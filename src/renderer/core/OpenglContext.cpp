@@ -1,4 +1,5 @@
 #include "renderer/core/OpenglContext.hpp"
+#include "renderer/core/GlState.hpp"
 
 #include "BuildSettings.hpp"
 
@@ -68,7 +69,7 @@ static void GLAPIENTRY openglDebugCallback(GLenum source, GLenum type, GLuint id
 
 static void framebufferSizeCallback(GLFWwindow* window, int width, int height)
 {
-    glViewport(0, 0, width, height);
+    GlState::viewport(0, 0, width, height);
 }
 
 OpenglContext::OpenglContext()
@@ -110,12 +111,14 @@ auto OpenglContext::init(std::string_view name, uint32_t width, uint32_t height)
 #endif // BUILD_TARGET == NATIVE_BUILD
 
 	glfwSetFramebufferSizeCallback(m_window, framebufferSizeCallback);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	glEnable(GL_CULL_FACE);
-	glEnable(GL_DEPTH_TEST);
-	glDepthFunc(GL_LESS);
+	// the context starts out in a state GlState knows nothing of.
+	GlState::invalidate();
+	GlState::setEnabled(GL_BLEND, true);
+	GlState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	GlState::setEnabled(GL_CULL_FACE, true);
+	GlState::setEnabled(GL_DEPTH_TEST, true);
+	GlState::depthFunc(GL_LESS);
 
 	return {};
 }
@@ -0,0 +1,157 @@
+#include "renderer/core/ProgramCache.hpp"
+#include "CacheFile.hpp"
+#include "MappedFile.hpp"
+
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace ProgramCache {
+	namespace {
+		Stats stats;
+
+		auto cachePath(uint64_t key) -> std::filesystem::path
+		{
+			constexpr std::string_view hex_digits = "0123456789abcdef";
+			std::string file_name(16, '0');
+			for (size_t i = 0; i < file_name.size(); ++i) {
+				file_name[file_name.size() - 1 - i] = hex_digits[(key >> (i * 4)) & 0xF];
+			}
+			file_name += extension;
+			return cache_directory / file_name;
+		}
+
+		auto getDriverString(uint32_t name) -> std::string_view
+		{
+			const auto* chars = reinterpret_cast<const char*>(glGetString(name));
+			return chars ? std::string_view{ chars } : std::string_view{};
+		}
+	}
+
+	auto getStats() noexcept -> const Stats&
+	{
+		return stats;
+	}
+
+	auto resetStats() noexcept -> void
+	{
+		stats = {};
+	}
+
+	auto recordUpload(bool was_loaded, std::chrono::duration<double, std::milli> time) noexcept -> void
+	{
+		++(was_loaded ? stats.loaded : stats.compiled);
+		(was_loaded ? stats.loading_time : stats.compiling_time) += time;
+	}
+
+	auto isSupported() noexcept -> bool
+	{
+#if BUILD_TARGET == NATIVE_BUILD
+		static const bool is_supported = [] {
+			if (!GLEW_ARB_get_program_binary) {
+				return false;
+			}
+			int32_t format_count = 0;
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+			return format_count > 0;
+		}();
+		return is_supported;
+#elif BUILD_TARGET == WEB_BUILD
+		return false;
+#endif
+	}
+
+	auto makeKey(std::span<const std::string_view> sources) noexcept -> uint64_t
+	{
+		// each part is followed by a NUL, so moving text between two parts changes the key.
+		std::string keyed;
+		auto append = [&](std::string_view part) {
+			keyed += part;
+			keyed += '\0';
+		};
+		append(getDriverString(GL_VENDOR));
+		append(getDriverString(GL_RENDERER));
+		append(getDriverString(GL_VERSION));
+		for (std::string_view source : sources) {
+			append(source);
+		}
+		return CacheFile::hashContent(keyed);
+	}
+
+	auto load(uint32_t program, uint64_t key) noexcept -> Expected<void, std::string_view>
+	{
+#if BUILD_TARGET == NATIVE_BUILD
+		const std::filesystem::path path = cachePath(key);
+		std::error_code error;
+		if (!std::filesystem::exists(path, error)) {
+			++stats.misses;
+			return { "No binary is cached for the program." };
+		}
+		MappedFile binary_file;
+		if (auto result = binary_file.init(path); result.HasError()) {
+			++stats.misses;
+			return { result.Error() };
+		}
+		std::span<const char> content = binary_file.getContent();
+
+		FileHeader header;
+		if (content.size() < sizeof(FileHeader)) {
+			++stats.misses;
+			return { "The cached program binary is truncated." };
+		}
+		std::memcpy(&header, content.data(), sizeof(FileHeader));
+		if (header.magic != magic || header.version != version || header.key != key) {
+			++stats.misses;
+			return { "The cached program binary is from another version, or for other sources." };
+		}
+		if (header.binary_size > content.size() - sizeof(FileHeader)) {
+			++stats.misses;
+			return { "The cached program binary is truncated." };
+		}
+
+		glProgramBinary(program, header.binary_format, content.data() + sizeof(FileHeader), static_cast<int32_t>(header.binary_size));
+		int32_t link_status = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &link_status);
+		if (link_status == GL_FALSE) {
+			++stats.rejections;
+			return { "The driver rejected the cached program binary." };
+		}
+		++stats.hits;
+		return {};
+#elif BUILD_TARGET == WEB_BUILD
+		++stats.misses;
+		return { "Program binaries aren't supported." };
+#endif
+	}
+
+	auto store(uint32_t program, uint64_t key) noexcept -> Expected<void, std::string_view>
+	{
+#if BUILD_TARGET == NATIVE_BUILD
+		int32_t binary_size = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binary_size);
+		if (binary_size <= 0) {
+			return { "The driver has no binary for the program." };
+		}
+		std::vector<char> binary(static_cast<size_t>(binary_size));
+		uint32_t binary_format = 0;
+		glGetProgramBinary(program, binary_size, &binary_size, &binary_format, binary.data());
+
+		const FileHeader header = {
+			.magic = magic,
+			.version = version,
+			.key = key,
+			.binary_format = binary_format,
+			.binary_size = static_cast<uint32_t>(binary_size),
+		};
+
+		return CacheFile::write(cachePath(key), [&](std::ostream& outfile) {
+			outfile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			outfile.write(binary.data(), binary_size);
+		});
+#elif BUILD_TARGET == WEB_BUILD
+		return { "Program binaries aren't supported." };
+#endif
+	}
+}
@@ -1,7 +1,13 @@
 #include "renderer/3d/MeshRenderer.hpp"
+#include "renderer/core/GlState.hpp"
+#include "renderer/core/ProgramCache.hpp"
+#include "renderer/core/UniformBuffer.hpp"
 
 #include "BuildSettings.hpp"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <fstream>
 #include <iostream>
 
@@ -33,6 +39,46 @@ static auto readRawFile(const std::filesystem::path& path) -> std::string
     }
 }
 
+// Splices the file in place of every line that is `#include "path"`, with the path relative to the including file.
+static auto resolveIncludes(const std::string& source, const std::filesystem::path& path, int depth = 0) -> std::string
+{
+    constexpr static auto include_directive = std::string_view { "#include \"" };
+    constexpr static int max_include_depth = 8;
+
+    std::string resolved;
+    resolved.reserve(source.size());
+
+    size_t line_begin = 0;
+    while (line_begin < source.size()) {
+        size_t line_end = source.find('\n', line_begin);
+        line_end = (line_end == std::string::npos) ? source.size() : line_end + 1;
+        auto line = std::string_view { source }.substr(line_begin, line_end - line_begin);
+        line_begin = line_end;
+
+        if (!line.starts_with(include_directive)) {
+            resolved += line;
+            continue;
+        }
+        auto include_name = line.substr(include_directive.size());
+        include_name = include_name.substr(0, include_name.find('"'));
+
+        if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+            if (depth >= max_include_depth) {
+                std::cerr
+                    << "Shader \""
+                    << path.string()
+                    << "\" nests includes too deeply, probably a cycle.\n"
+                    << std::endl;
+                exit(EXIT_FAILURE);
+            }
+        }
+        auto include_path = path.parent_path() / include_name;
+        resolved += resolveIncludes(readRawFile(include_path), include_path, depth + 1);
+        resolved += '\n';
+    }
+    return resolved;
+}
+
 static auto compileShader(uint32_t type, const std::string& source, const std::filesystem::path& path) -> uint32_t
 {
     uint32_t shader = glCreateShader(type);
@@ -68,8 +114,15 @@ static auto compileShader(uint32_t type, const std::string& source, const std::f
 
 void Shader::uploadToGpu() noexcept
 {
-    std::string vert_shader_source = readRawFile(m_vert_shader_path);
-    std::string frag_shader_source = readRawFile(m_frag_shader_path);
+    const auto start_time = std::chrono::steady_clock::now();
+
+    std::string vert_shader_source = resolveIncludes(readRawFile(m_vert_shader_path), m_vert_shader_path);
+    std::string frag_shader_source = resolveIncludes(readRawFile(m_frag_shader_path), m_frag_shader_path);
+#if BUILD_TARGET == NATIVE_BUILD
+    std::optional<std::string> geo_shader_source = m_geo_shader_path.transform([](const std::filesystem::path& geo_path) {
+        return resolveIncludes(readRawFile(geo_path), geo_path);
+    });
+#endif
 
 #if BUILD_TARGET == WEB_BUILD
 	const static auto shader_version = std::string{"#version 300 es \n"};
@@ -78,44 +131,92 @@ void Shader::uploadToGpu() noexcept
 #endif
 	const static auto to_replace = std::string{"#version 300"};
 
-	vert_shader_source.replace(0, to_replace.length(), shader_version);
-	frag_shader_source.replace(0, to_replace.length(), shader_version);
+	// defines go straight after the version line, so they are seen by any included files.
+	std::string shader_header = shader_version;
+	if constexpr (BuildSettings::quantised_vertices) {
+		shader_header += "#define QUANTISED_VERTICES\n";
+	}
+
+	vert_shader_source.replace(0, to_replace.length(), shader_header);
+	frag_shader_source.replace(0, to_replace.length(), shader_header);
 
     m_program_id = glCreateProgram();
 
-    uint32_t vert_id = compileShader(GL_VERTEX_SHADER, vert_shader_source, m_vert_shader_path);
-    uint32_t frag_id = compileShader(GL_FRAGMENT_SHADER, frag_shader_source, m_frag_shader_path);
+    bool is_loaded = false;
+#if BUILD_TARGET == NATIVE_BUILD
+    const auto sources = std::array<std::string_view, 3> { vert_shader_source, frag_shader_source, geo_shader_source.value_or("") };
+    const uint64_t cache_key = ProgramCache::makeKey(sources);
+    if (ProgramCache::isSupported()) {
+        is_loaded = ProgramCache::load(m_program_id.value(), cache_key).HasValue();
+    }
+#endif
+
+    if (!is_loaded) {
+        uint32_t vert_id = compileShader(GL_VERTEX_SHADER, vert_shader_source, m_vert_shader_path);
+        uint32_t frag_id = compileShader(GL_FRAGMENT_SHADER, frag_shader_source, m_frag_shader_path);
 
 #if BUILD_TARGET == NATIVE_BUILD
-    std::optional<uint32_t> geo_id = m_geo_shader_path.transform([&](std::filesystem::path geo_path) {
-        std::string geo_shader_source = readRawFile(geo_path);
-        return compileShader(GL_GEOMETRY_SHADER, geo_shader_source, geo_path);
-    });
+        std::optional<uint32_t> geo_id = geo_shader_source.transform([&](const std::string& source) {
+            return compileShader(GL_GEOMETRY_SHADER, source, m_geo_shader_path.value());
+        });
 #endif
 
-    glAttachShader(m_program_id.value(), vert_id);
+        glAttachShader(m_program_id.value(), vert_id);
 
 #if BUILD_TARGET == NATIVE_BUILD
-    geo_id.and_then([&](uint32_t id) {
-        glAttachShader(m_program_id.value(), id);
-        return std::optional(id);
-    });
+        geo_id.and_then([&](uint32_t id) {
+            glAttachShader(m_program_id.value(), id);
+            return std::optional(id);
+        });
+        if (ProgramCache::isSupported()) {
+            glProgramParameteri(m_program_id.value(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
 #endif
-    glAttachShader(m_program_id.value(), frag_id);
-    glLinkProgram(m_program_id.value());
-    glValidateProgram(m_program_id.value());
+        glAttachShader(m_program_id.value(), frag_id);
+        glLinkProgram(m_program_id.value());
+
+        // checked in every build, a program that failed to link would otherwise draw nothing without a word.
+        int32_t link_status = GL_FALSE;
+        glGetProgramiv(m_program_id.value(), GL_LINK_STATUS, &link_status);
+        if (link_status == GL_FALSE) {
+            int32_t length = 0;
+            glGetProgramiv(m_program_id.value(), GL_INFO_LOG_LENGTH, &length);
+            std::vector<char> error_chars(std::max(length, 1), '\0');
+            glGetProgramInfoLog(m_program_id.value(), length, nullptr, error_chars.data());
+
+            std::cerr
+                << "Program failed to link: "
+                << "\""
+                << m_vert_shader_path.string()
+                << "\".\n"
+                << error_chars.data()
+                << '\n'
+                << std::endl;
+
+            exit(EXIT_FAILURE);
+        }
 
-    glDeleteShader(vert_id);
-    glDeleteShader(frag_id);
+        glDeleteShader(vert_id);
+        glDeleteShader(frag_id);
 
 #if BUILD_TARGET == NATIVE_BUILD
-    geo_id.and_then([&](uint32_t id) {
-        glDeleteShader(id);
-        return std::optional(id);
-    });
+        geo_id.and_then([&](uint32_t id) {
+            glDeleteShader(id);
+            return std::optional(id);
+        });
+        if (ProgramCache::isSupported()) {
+            ProgramCache::store(m_program_id.value(), cache_key)
+                .OnError([&](std::string_view error) {
+                    std::cerr << "Failed to cache the program of " << m_vert_shader_path << ": " << error << std::endl;
+                });
+        }
 #endif
+    }
+    reflect();
 
+    // only checked in debug builds, validating stalls on the driver for nothing otherwise.
     if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+        glValidateProgram(m_program_id.value());
         int32_t validation_status = GL_FALSE;
         glGetProgramiv(m_program_id.value(), GL_VALIDATE_STATUS, &validation_status);
         if (!validation_status) {
@@ -137,7 +238,9 @@ void Shader::uploadToGpu() noexcept
             exit(EXIT_FAILURE);
         }
     }
-    glUseProgram(m_program_id.value());
+    GlState::useProgram(m_program_id.value());
+
+    ProgramCache::recordUpload(is_loaded, std::chrono::steady_clock::now() - start_time);
 }
 void Shader::bind() noexcept
 {
@@ -148,7 +251,7 @@ void Shader::bind() noexcept
             exit(EXIT_FAILURE);
         }
     }
-    glUseProgram(m_program_id.value());
+    GlState::useProgram(m_program_id.value());
 }
 void Shader::unbind() noexcept
 {
@@ -159,15 +262,18 @@ void Shader::unbind() noexcept
             exit(EXIT_FAILURE);
         }
     }
-    glUseProgram(0);
+    GlState::useProgram(0);
 }
 void Shader::offloadFromGpu() noexcept
 {
     if (m_program_id) {
+        GlState::forgetProgram(m_program_id.value());
         glDeleteProgram(m_program_id.value());
     }
     m_program_id = std::nullopt;
-    m_uniforms_lookup.clear();
+    m_uniforms.clear();
+    m_blocks.clear();
+    m_attributes.clear();
 }
 void Shader::init(std::filesystem::path vert_shader_path, std::filesystem::path frag_shader_path, std::optional<std::filesystem::path> geo_shader_path) noexcept
 {
@@ -192,82 +298,201 @@ void Shader::stop() noexcept
 }
 auto Shader::setUniform(const std::string_view& key, const glm::mat4& value) -> Expected<void, std::string_view>
 {
-    auto setUniformAtIndex = [&](int32_t index) -> void {
-        this->bind();
-        glUniformMatrix4fv(index, 1, GL_FALSE, (const float*)&value[0][0]);
-    };
-
-    if (auto result = getUniformIndex(key).OnValue(setUniformAtIndex); result.HasError()) {
-        return { result.Error() };
+    if (auto handle = getUniform<glm::mat4>(key); handle.HasError()) {
+        return { handle.Error() };
     } else {
+        setUniform(handle.Value(), value);
         return {};
     }
 }
 auto Shader::setUniform(const std::string_view& key, const glm::vec3& value) -> Expected<void, std::string_view>
 {
-    auto setUniformAtIndex = [&](int32_t index) -> void {
-        this->bind();
-        glUniform3f(index, value.x, value.y, value.z);
-    };
-    if (auto result = getUniformIndex(key).OnValue(setUniformAtIndex); result.HasError()) {
-        return { result.Error() };
+    if (auto handle = getUniform<glm::vec3>(key); handle.HasError()) {
+        return { handle.Error() };
     } else {
+        setUniform(handle.Value(), value);
         return {};
     }
 }
 auto Shader::setUniform(const std::string_view& key, const float value) -> Expected<void, std::string_view>
 {
-    auto setUniformAtIndex = [&](int32_t index) -> void {
-        this->bind();
-        glUniform1f(index, value);
-    };
-    if (auto result = getUniformIndex(key).OnValue(setUniformAtIndex); result.HasError()) {
-        return { result.Error() };
+    if (auto handle = getUniform<float>(key); handle.HasError()) {
+        return { handle.Error() };
     } else {
+        setUniform(handle.Value(), value);
         return {};
     }
 }
 auto Shader::setUniform(const std::string_view& key, const int32_t value) -> Expected<void, std::string_view>
 {
-    auto setUniformAtIndex = [&](int32_t index) -> void {
-        this->bind();
-        glUniform1i(index, value);
-    };
-    if (auto result = getUniformIndex(key).OnValue(setUniformAtIndex); result.HasError()) {
-        return { result.Error() };
+    if (auto handle = getUniform<int32_t>(key); handle.HasError()) {
+        return { handle.Error() };
     } else {
+        setUniform(handle.Value(), value);
         return {};
     }
 }
+auto Shader::getAttributeLocation(std::string_view name) const -> Expected<int32_t, std::string_view>
+{
+    auto attribute_it = std::ranges::find(m_attributes, name, &ReflectedAttribute::name);
+    if (attribute_it == m_attributes.end()) {
+        return { name };
+    }
+    return attribute_it->location;
+}
 
 Shader::~Shader()
 {
     this->stop();
 }
 
-auto Shader::getUniformIndex(const std::string_view& key) -> Expected<int32_t, std::string_view>
+void Shader::reflect() noexcept
 {
+    const uint32_t program = m_program_id.value();
+    m_uniforms.clear();
+    m_blocks.clear();
+    m_attributes.clear();
+
+    // lengths include the NUL, the names are read into one buffer long enough for any of them.
+    int32_t max_uniform_length = 0;
+    int32_t max_block_length = 0;
+    int32_t max_attribute_length = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_uniform_length);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &max_block_length);
+    glGetProgramiv(program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &max_attribute_length);
+    std::vector<char> name_chars(std::max({ max_uniform_length, max_block_length, max_attribute_length, int32_t { 1 } }));
+    const auto name_capacity = static_cast<int32_t>(name_chars.size());
+
+    auto addUniform = [&](std::string name, int32_t location, uint32_t type) {
+        const uint64_t name_hash = hashName(name);
+        m_uniforms.push_back({ .name = std::move(name), .name_hash = name_hash, .location = location, .type = type, .value = {}, .has_value = false });
+    };
+
+    int32_t uniform_count = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &uniform_count);
+    for (int32_t i = 0; i < uniform_count; ++i) {
+        int32_t length = 0;
+        int32_t size = 0;
+        uint32_t type = 0;
+        glGetActiveUniform(program, static_cast<uint32_t>(i), name_capacity, &length, &size, &type, name_chars.data());
+        std::string name(name_chars.data(), length);
+
+        // block members have no location, they are set through their block's buffer.
+        const int32_t location = glGetUniformLocation(program, name.c_str());
+        if (location == -1) {
+            continue;
+        }
+        // arrays are reported once, as their first element.
+        constexpr static auto first_element = std::string_view { "[0]" };
+        if (!name.ends_with(first_element)) {
+            addUniform(std::move(name), location, type);
+            continue;
+        }
+        name.resize(name.size() - first_element.size());
+        for (int32_t element = 0; element < size; ++element) {
+            std::string element_name = name + '[' + std::to_string(element) + ']';
+            const int32_t element_location = glGetUniformLocation(program, element_name.c_str());
+            addUniform(std::move(element_name), element_location, type);
+        }
+        addUniform(std::move(name), location, type);
+    }
+    std::ranges::sort(m_uniforms, {}, &ReflectedUniform::name_hash);
+
     if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
-        if (!m_program_id) {
+        auto collision = std::ranges::adjacent_find(m_uniforms, {}, &ReflectedUniform::name_hash);
+        if (collision != m_uniforms.end()) {
             std::cerr
-                << "Trying to find uniform of shader that doesn't have an program id.\n"
+                << "Shader \""
+                << m_vert_shader_path.string()
+                << "\" has two uniforms with the same name hash, rename \""
+                << collision->name
+                << "\".\n"
                 << std::endl;
             exit(EXIT_FAILURE);
         }
     }
 
-    auto hash = std::hash<std::string_view> {}(key);
+    int32_t block_count = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &block_count);
+    for (int32_t i = 0; i < block_count; ++i) {
+        int32_t length = 0;
+        int32_t size_in_bytes = 0;
+        glGetActiveUniformBlockName(program, static_cast<uint32_t>(i), name_capacity, &length, name_chars.data());
+        glGetActiveUniformBlockiv(program, static_cast<uint32_t>(i), GL_UNIFORM_BLOCK_DATA_SIZE, &size_in_bytes);
+        m_blocks.push_back({ .name = std::string(name_chars.data(), length), .index = static_cast<uint32_t>(i), .size_in_bytes = static_cast<size_t>(size_in_bytes) });
+    }
 
-    if (m_uniforms_lookup.contains(hash)) {
-        return m_uniforms_lookup[hash];
+    // glsl 330 and 300 es can't declare a block's binding, so it's set by name.
+    for (const ReflectedBlock& block : m_blocks) {
+        auto binding_it = std::ranges::find(UniformBlocks::bindings, std::string_view { block.name }, &UniformBlocks::Binding::name);
+        if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+            if (binding_it == UniformBlocks::bindings.end() || block.size_in_bytes > binding_it->size_in_bytes) {
+                std::cerr
+                    << "Shader \""
+                    << m_vert_shader_path.string()
+                    << "\" has a uniform block \""
+                    << block.name
+                    << "\" that isn't in UniformBlocks, or is larger than its struct there.\n"
+                    << std::endl;
+                exit(EXIT_FAILURE);
+            }
+        }
+        if (binding_it != UniformBlocks::bindings.end()) {
+            glUniformBlockBinding(program, block.index, binding_it->binding);
+        }
     }
 
-    int32_t uniform_index = glGetUniformLocation(m_program_id.value(), key.data());
+    int32_t attribute_count = 0;
+    glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &attribute_count);
+    for (int32_t i = 0; i < attribute_count; ++i) {
+        int32_t length = 0;
+        int32_t size = 0;
+        uint32_t type = 0;
+        glGetActiveAttrib(program, static_cast<uint32_t>(i), name_capacity, &length, &size, &type, name_chars.data());
+        std::string name(name_chars.data(), length);
+        const int32_t location = glGetAttribLocation(program, name.c_str());
+        m_attributes.push_back({ .name = std::move(name), .location = location, .type = type });
+    }
+}
+
+auto Shader::findUniform(std::string_view name) const noexcept -> std::optional<uint32_t>
+{
+    // the name is compared too, a name the program doesn't use could share an active one's hash.
+    return findUniform(hashName(name)).and_then([&](uint32_t index) -> std::optional<uint32_t> {
+        return (m_uniforms[index].name == name) ? std::optional(index) : std::nullopt;
+    });
+}
 
-    if (uniform_index == -1) {
-        return { key };
+auto Shader::findUniform(uint64_t name_hash) const noexcept -> std::optional<uint32_t>
+{
+    if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+        if (!m_program_id) {
+            std::cerr
+                << "Trying to find uniform of shader that doesn't have an program id.\n"
+                << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    auto uniform_it = std::ranges::lower_bound(m_uniforms, name_hash, {}, &ReflectedUniform::name_hash);
+    if (uniform_it == m_uniforms.end() || uniform_it->name_hash != name_hash) {
+        return std::nullopt;
     }
+    return static_cast<uint32_t>(uniform_it - m_uniforms.begin());
+}
 
-    m_uniforms_lookup.emplace(hash, uniform_index);
-    return uniform_index;
+void Shader::uploadUniform(int32_t location, const glm::mat4& value) noexcept
+{
+    glUniformMatrix4fv(location, 1, GL_FALSE, (const float*)&value[0][0]);
+}
+void Shader::uploadUniform(int32_t location, const glm::vec3& value) noexcept
+{
+    glUniform3f(location, value.x, value.y, value.z);
+}
+void Shader::uploadUniform(int32_t location, float value) noexcept
+{
+    glUniform1f(location, value);
+}
+void Shader::uploadUniform(int32_t location, int32_t value) noexcept
+{
+    glUniform1i(location, value);
 }
@@ -0,0 +1,55 @@
+#include "renderer/core/StreamBuffer.hpp"
+#include "renderer/core/GlState.hpp"
+
+namespace FrameStream {
+	namespace {
+		StreamBuffer<VertexBuffer> vertex_stream;
+		StreamBuffer<IndexBuffer> index_stream;
+		StreamBuffer<UniformBuffer> uniform_stream;
+	}
+
+	auto vertices() noexcept -> StreamBuffer<VertexBuffer>&
+	{
+		return vertex_stream;
+	}
+
+	auto indices() noexcept -> StreamBuffer<IndexBuffer>&
+	{
+		return index_stream;
+	}
+
+	auto uniforms() noexcept -> StreamBuffer<UniformBuffer>&
+	{
+		return uniform_stream;
+	}
+
+	auto init() noexcept -> void
+	{
+		// the index buffer binding belongs to whichever vertex array is bound.
+		GlState::bindVertexArray(0);
+		vertex_stream.init(vertex_bytes_per_frame);
+		index_stream.init(index_bytes_per_frame);
+		uniform_stream.init(uniform_bytes_per_frame);
+	}
+
+	auto stop() noexcept -> void
+	{
+		vertex_stream.stop();
+		index_stream.stop();
+		uniform_stream.stop();
+	}
+
+	auto beginFrame() noexcept -> void
+	{
+		vertex_stream.beginFrame();
+		index_stream.beginFrame();
+		uniform_stream.beginFrame();
+	}
+
+	auto endFrame() noexcept -> void
+	{
+		vertex_stream.endFrame();
+		index_stream.endFrame();
+		uniform_stream.endFrame();
+	}
+}
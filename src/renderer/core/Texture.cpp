@@ -1,4 +1,5 @@
 #include "renderer/core/Texture.hpp"
+#include "renderer/core/GlState.hpp"
 
 #include "BuildSettings.hpp"
 
@@ -27,7 +28,7 @@ void Texture::uploadToGpu() noexcept
 	if (!m_texture_id) {
 		m_texture_id = 0;
 		glGenTextures(1, &(m_texture_id.value()));
-		glBindTexture(GL_TEXTURE_2D, m_texture_id.value());
+		GlState::bindTexture(GL_TEXTURE_2D, m_texture_id.value());
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
@@ -43,6 +44,7 @@ void Texture::offloadFromGpu() noexcept
 {
 	unbind();
 	if (m_texture_id) {
+		GlState::forgetTexture(m_texture_id.value());
 		glDeleteTextures(1, &(m_texture_id.value()));
 	}
 	m_texture_id = std::nullopt;
@@ -57,12 +59,17 @@ void Texture::bind(uint32_t slot) noexcept
 			exit(EXIT_FAILURE);
 		}
 	}
-	glActiveTexture(GL_TEXTURE0 + slot);
-	glBindTexture(GL_TEXTURE_2D, m_texture_id.value_or(0));
+	GlState::activeTexture(slot);
+	GlState::bindTexture(GL_TEXTURE_2D, m_texture_id.value_or(0));
+	m_bound_slot = slot;
 }
 void Texture::unbind() noexcept
 {
-	glBindTexture(GL_TEXTURE_2D, 0);
+	if (m_bound_slot) {
+		GlState::activeTexture(m_bound_slot.value());
+		GlState::bindTexture(GL_TEXTURE_2D, 0);
+		m_bound_slot = std::nullopt;
+	}
 }
 void Texture::init(std::filesystem::path texture_path) noexcept
 {
@@ -89,32 +96,56 @@ void Texture::init(std::filesystem::path texture_path) noexcept
 
 	loadImageFromDisk();
 }
+void Texture::init(std::filesystem::path texture_path, Image image) noexcept
+{
+	m_texture_path = std::move(texture_path);
+	m_image = std::move(image);
+	m_is_translucent = hasTranslucentTexels(m_image.value());
+}
 void Texture::stop() noexcept
 {
 	offloadFromGpu();
 	m_image = std::nullopt;
+	m_is_translucent = false;
 }
 
-void Texture::loadImageFromDisk()
+auto Texture::loadImage(const std::filesystem::path& texture_path) noexcept -> Expected<Image, std::string_view>
 {
 	std::vector<uint8_t> encrypted_image;
-	lodepng::load_file(encrypted_image, m_texture_path.string());
-	m_image = Image{};
+	if (lodepng::load_file(encrypted_image, texture_path.string()) != 0) {
+		return { "Unable to read the texture file." };
+	}
+	Image image{};
+	if (auto lodepng_error = lodepng::decode(image.data, image.width, image.height, encrypted_image); lodepng_error) {
+		return { std::string_view{ lodepng_error_text(lodepng_error) } };
+	}
+	return image;
+}
 
-	[[maybe_unused]] auto lodepng_error = lodepng::decode(
-		m_image.value().data,
-		m_image.value().width,
-		m_image.value().height,
-		encrypted_image
-	);
+void Texture::loadImageFromDisk()
+{
+	loadImage(m_texture_path)
+		.OnValue([&](Image& image) {
+			m_image = std::move(image);
+			m_is_translucent = hasTranslucentTexels(m_image.value());
+		})
+		.OnError([&](std::string_view error) {
+			if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+				std::cerr
+					<< "Error decoding image where lodepng was: "
+					<< error;
+				exit(EXIT_FAILURE);
+			}
+		});
+}
 
-	if constexpr (BuildSettings::mode != BuildSettings::Mode::release)
-	{
-		if (lodepng_error) {
-			std::cerr
-				<< "Error decoding image where lodepng was: "
-				<< lodepng_error_text(lodepng_error);
-			exit(EXIT_FAILURE);
+auto Texture::hasTranslucentTexels(const Image& image) noexcept -> bool
+{
+	// rgba8, every fourth byte is an alpha.
+	for (size_t i = 3; i < image.data.size(); i += 4) {
+		if (image.data[i] != 255) {
+			return true;
 		}
 	}
+	return false;
 }
@@ -0,0 +1,89 @@
+#include "renderer/core/UniformBuffer.hpp"
+#include "renderer/core/GlState.hpp"
+
+auto UniformBuffer::init() noexcept -> void
+{
+    this->stop();
+    uint32_t temp_ubo;
+    glGenBuffers(1, &temp_ubo);
+    if (temp_ubo != 0) {
+        m_ubo = temp_ubo;
+    } else {
+        m_ubo = std::nullopt;
+    }
+}
+
+auto UniformBuffer::stop() noexcept -> void
+{
+    if (m_ubo) {
+        this->unbind();
+        GlState::forgetBuffer(m_ubo.value());
+        glDeleteBuffers(1, &m_ubo.value());
+        m_ubo = std::nullopt;
+    }
+}
+
+auto UniformBuffer::bind() noexcept -> void
+{
+    if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+        if (!m_ubo) {
+            std::cerr << "UniformBuffer failed, trying to \"bind\" an unitialised uniform buffer object.";
+            exit(EXIT_FAILURE);
+        }
+    }
+    GlState::bindBuffer(GL_UNIFORM_BUFFER, m_ubo.value());
+}
+
+auto UniformBuffer::unbind() noexcept -> void
+{
+    if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+        if (!m_ubo) {
+            std::cerr << "UniformBuffer failed, trying to \"unbind\" an unitialised uniform buffer object.";
+            exit(EXIT_FAILURE);
+        }
+    }
+    GlState::bindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+auto UniformBuffer::reserve(size_t size_in_bytes, uint32_t usage) noexcept -> void
+{
+    if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+        if (!m_ubo) {
+            std::cerr << "UniformBuffer failed, trying to \"reserve\" an unitialised uniform buffer object.";
+            exit(EXIT_FAILURE);
+        }
+    }
+    this->bind();
+    glBufferData(GL_UNIFORM_BUFFER, size_in_bytes, nullptr, usage);
+}
+
+auto UniformBuffer::bindRange(uint32_t binding, size_t offset_in_bytes, size_t size_in_bytes) noexcept -> void
+{
+    if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+        if (!m_ubo) {
+            std::cerr << "UniformBuffer failed, trying to \"bind a range\" of an unitialised uniform buffer object.";
+            exit(EXIT_FAILURE);
+        }
+        if (offset_in_bytes % getOffsetAlignment() != 0) {
+            std::cerr << "UniformBuffer failed, the range's offset " << offset_in_bytes << " isn't a multiple of " << getOffsetAlignment() << ".";
+            exit(EXIT_FAILURE);
+        }
+    }
+    GlState::bindBufferRange(GL_UNIFORM_BUFFER, binding, m_ubo.value(), offset_in_bytes, size_in_bytes);
+}
+
+auto UniformBuffer::getOffsetAlignment() noexcept -> size_t
+{
+    static const size_t alignment = [] {
+        int32_t value = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &value);
+        // the spec's largest allowed value, should the query fail.
+        return value > 0 ? static_cast<size_t>(value) : size_t { 256 };
+    }();
+    return alignment;
+}
+
+UniformBuffer::~UniformBuffer()
+{
+    this->stop();
+}
@@ -1,4 +1,5 @@
 #include "renderer/core/VertexArray.hpp"
+#include "renderer/core/GlState.hpp"
 
 auto VertexArray::init() noexcept -> void
 {
@@ -19,6 +20,7 @@ auto VertexArray::stop() noexcept -> void
 {
 	if (m_vao) {
 		this->unbind();
+		GlState::forgetVertexArray(m_vao.value());
 		glDeleteVertexArrays(1, &m_vao.value());
 		m_vao = std::nullopt;
 	}
@@ -32,7 +34,7 @@ auto VertexArray::bind() noexcept -> void
 			exit(EXIT_FAILURE);
 		}
 	}
-	glBindVertexArray(m_vao.value());
+	GlState::bindVertexArray(m_vao.value());
 }
 
 auto VertexArray::unbind() noexcept -> void
@@ -43,10 +45,10 @@ auto VertexArray::unbind() noexcept -> void
 			exit(EXIT_FAILURE);
 		}
 	}
-	glBindVertexArray(0);
+	GlState::bindVertexArray(0);
 }
 
-auto VertexArray::attachBufferAndLayout(VertexBuffer& vb, VertexBufferLayout& layout) -> void
+auto VertexArray::attachBufferAndLayout(VertexBuffer& vb, VertexBufferLayout& layout, uint32_t first_location, size_t offset_in_bytes, uint32_t divisor) -> void
 {
 	if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
 		if (!m_vao) {
@@ -59,19 +61,21 @@ auto VertexArray::attachBufferAndLayout(VertexBuffer& vb, VertexBufferLayout& la
 	vb.bind();
 
 #if BUILD_TARGET == NATIVE_BUILD
-	uint32_t offset = 0;
+	size_t offset = offset_in_bytes;
 	for (size_t i = 0; i < layout.elements.size(); i++) {
 		const auto& element = layout.elements[i];
-		glEnableVertexArrayAttrib(m_vao.value(), i);
-		glVertexAttribPointer(i, element.count, element.type, element.normalised, layout.stride, (const void*)offset);
+		glEnableVertexArrayAttrib(m_vao.value(), first_location + i);
+		glVertexAttribPointer(first_location + i, element.count, element.type, element.normalised, layout.stride, (const void*)offset);
+		glVertexAttribDivisor(first_location + i, divisor);
 		offset += element.count * element.getTypeSize();
 	}
 #elif BUILD_TARGET == WEB_BUILD
-	uint32_t offset = 0;
+	size_t offset = offset_in_bytes;
 	for (size_t i = 0; i < layout.elements.size(); i++) {
 		const auto& element = layout.elements[i];
-		glEnableVertexAttribArray(i); 
-		glVertexAttribPointer(i, element.count, element.type, element.normalised, layout.stride, reinterpret_cast<const void*>(offset));
+		glEnableVertexAttribArray(first_location + i); 
+		glVertexAttribPointer(first_location + i, element.count, element.type, element.normalised, layout.stride, reinterpret_cast<const void*>(offset));
+		glVertexAttribDivisor(first_location + i, divisor);
 		offset += element.count * element.getTypeSize();
 	}
 #endif
@@ -1,4 +1,5 @@
 #include "renderer/core/VertexBuffer.hpp"
+#include "renderer/core/GlState.hpp"
 
 auto VertexBuffer::init() noexcept -> void
 {
@@ -16,6 +17,7 @@ auto VertexBuffer::stop() noexcept -> void
 {
     if (m_vbo) {
         this->unbind();
+        GlState::forgetBuffer(m_vbo.value());
         glDeleteBuffers(1, &m_vbo.value());
         m_vbo = std::nullopt;
     }
@@ -29,7 +31,18 @@ auto VertexBuffer::bind() noexcept -> void
             exit(EXIT_FAILURE);
         }
     }
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo.value());
+    GlState::bindBuffer(GL_ARRAY_BUFFER, m_vbo.value());
+}
+
+auto VertexBuffer::bindAs(uint32_t target) noexcept -> void
+{
+    if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+        if (!m_vbo) {
+            std::cerr << "VertexBuffer failed, trying to \"bind\" an unitialised vertex buffer object.";
+            exit(EXIT_FAILURE);
+        }
+    }
+    GlState::bindBuffer(target, m_vbo.value());
 }
 
 auto VertexBuffer::unbind() noexcept -> void
@@ -40,7 +53,34 @@ auto VertexBuffer::unbind() noexcept -> void
             exit(EXIT_FAILURE);
         }
     }
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+auto VertexBuffer::reserve(size_t size_in_bytes, uint32_t usage) noexcept -> void
+{
+    if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+        if (!m_vbo) {
+            std::cerr << "VertexBuffer failed, trying to \"reserve\" an unitialised vertex buffer object.";
+            exit(EXIT_FAILURE);
+        }
+    }
+    this->bind();
+    glBufferData(GL_ARRAY_BUFFER, size_in_bytes, nullptr, usage);
+}
+
+auto VertexBuffer::copyFrom(VertexBuffer& source, size_t source_offset_in_bytes, size_t offset_in_bytes, size_t size_in_bytes) noexcept -> void
+{
+    if constexpr (BuildSettings::mode != BuildSettings::Mode::release) {
+        if (!m_vbo || !source.m_vbo || m_vbo == source.m_vbo) {
+            std::cerr << "VertexBuffer failed, trying to \"copy\" between unitialised or identical vertex buffer objects.";
+            exit(EXIT_FAILURE);
+        }
+    }
+    GlState::bindBuffer(GL_COPY_READ_BUFFER, source.m_vbo.value());
+    GlState::bindBuffer(GL_COPY_WRITE_BUFFER, m_vbo.value());
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, source_offset_in_bytes, offset_in_bytes, size_in_bytes);
+    GlState::bindBuffer(GL_COPY_READ_BUFFER, 0);
+    GlState::bindBuffer(GL_COPY_WRITE_BUFFER, 0);
 }
 
 VertexBuffer::~VertexBuffer()
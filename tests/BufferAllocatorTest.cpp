@@ -0,0 +1,312 @@
+// Checks BufferAllocator's best fit and merge on free against hand worked cases and a model of every unit.
+// Run with the name of a misuse, e.g. `BufferAllocatorTest double_free`, to check that debug builds stop on it.
+#include "renderer/core/BufferAllocator.hpp"
+#include "BuildSettings.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+	uint64_t failures = 0;
+
+	auto expect(bool condition, std::string_view what) -> void
+	{
+		if (!condition) {
+			++failures;
+			std::cerr << what << '\n';
+		}
+	}
+
+	auto expectState(const BufferAllocator& allocator, uint32_t free_size, size_t free_block_count, std::string_view what) -> void
+	{
+		if (allocator.getFreeSize() != free_size || allocator.getFreeBlockCount() != free_block_count) {
+			++failures;
+			std::cerr
+				<< what << ": " << allocator.getFreeSize() << " free in " << allocator.getFreeBlockCount() << " blocks, expected "
+				<< free_size << " free in " << free_block_count << " blocks.\n";
+		}
+	}
+
+	auto expectRange(std::optional<BufferAllocator::Range> range, uint32_t offset, uint32_t size, std::string_view what) -> void
+	{
+		if (!range || range->offset != offset || range->size != size) {
+			++failures;
+			std::cerr << what << ": got ";
+			if (range) {
+				std::cerr << range->size << " at " << range->offset;
+			}
+			else {
+				std::cerr << "nothing";
+			}
+			std::cerr << ", expected " << size << " at " << offset << ".\n";
+		}
+	}
+
+	auto checkEmptyAndZeroSize() -> void
+	{
+		BufferAllocator allocator;
+		allocator.init(0);
+		expectState(allocator, 0, 0, "Empty allocator");
+		expect(!allocator.allocate(1), "An empty allocator handed out a range.");
+		expectRange(allocator.allocate(0), 0, 0, "Zero sized range from an empty allocator");
+
+		allocator.init(16);
+		expectRange(allocator.allocate(0), 0, 0, "Zero sized range");
+		expectState(allocator, 16, 1, "After a zero sized allocation");
+		const auto all = allocator.allocate(16);
+		expectRange(all, 0, 16, "Whole capacity");
+		// freeing nothing is fine even with nothing free around it.
+		allocator.free({ 0, 0 });
+		allocator.free({ 16, 0 });
+		expectState(allocator, 0, 0, "After freeing zero sized ranges");
+		expectRange(allocator.allocate(0), 0, 0, "Zero sized range from a full allocator");
+	}
+
+	auto checkExactFit() -> void
+	{
+		BufferAllocator allocator;
+		allocator.init(10);
+		const auto all = allocator.allocate(10);
+		expectRange(all, 0, 10, "Exact fit of the capacity");
+		expectState(allocator, 0, 0, "After an exact fit");
+		expect(!allocator.allocate(1), "A full allocator handed out a range.");
+		allocator.free(*all);
+		expectState(allocator, 10, 1, "After freeing the exact fit");
+		expect(!allocator.allocate(11), "An allocation larger than the capacity succeeded.");
+
+		// an exact fit inside the buffer leaves no sliver behind.
+		allocator.init(30);
+		const auto a = allocator.allocate(10);
+		const auto b = allocator.allocate(10);
+		const auto c = allocator.allocate(10);
+		allocator.free(*b);
+		expectRange(allocator.allocate(10), 10, 10, "Exact fit of a hole");
+		expectState(allocator, 0, 0, "After filling the hole");
+		allocator.free(*a);
+		allocator.free(*c);
+		expectState(allocator, 20, 2, "After freeing both ends");
+	}
+
+	auto checkBestFit() -> void
+	{
+		BufferAllocator allocator;
+		allocator.init(100);
+		const auto a = allocator.allocate(10);
+		const auto b = allocator.allocate(20);
+		const auto c = allocator.allocate(5);
+		const auto d = allocator.allocate(30);
+		const auto e = allocator.allocate(35);
+		expectRange(a, 0, 10, "First allocation");
+		expectRange(e, 65, 35, "Last allocation");
+		expectState(allocator, 0, 0, "After filling the capacity");
+
+		allocator.free(*d);
+		allocator.free(*b);
+		expectState(allocator, 50, 2, "With a 20 and a 30 hole");
+		expectRange(allocator.allocate(15), 10, 15, "Best fit of 15 takes the 20 hole");
+		expectRange(allocator.allocate(25), 35, 25, "Best fit of 25 takes the 30 hole");
+		expectState(allocator, 10, 2, "With two 5 holes");
+		expect(!allocator.allocate(6), "A range larger than any hole was handed out, though the total free is enough.");
+		// equally good fits go to the lowest offset.
+		expectRange(allocator.allocate(5), 25, 5, "Tie between two 5 holes");
+		allocator.free(*c);
+		allocator.free(*a);
+		expectState(allocator, 20, 3, "After freeing the first and third allocations");
+	}
+
+	auto checkMerges() -> void
+	{
+		BufferAllocator allocator;
+		allocator.init(40);
+		std::array<BufferAllocator::Range, 4> ranges;
+		for (BufferAllocator::Range& range : ranges) {
+			range = *allocator.allocate(10);
+		}
+
+		allocator.free(ranges[1]);
+		expectState(allocator, 10, 1, "No free neighbours");
+		allocator.free(ranges[3]);
+		expectState(allocator, 20, 2, "Neighbours that aren't free");
+		allocator.free(ranges[2]);
+		expectState(allocator, 30, 1, "Merged with both neighbours");
+		expectRange(allocator.allocate(30), 10, 30, "The merged block");
+		allocator.free({ 10, 30 });
+		allocator.free(ranges[0]);
+		expectState(allocator, 40, 1, "Merged with the next neighbour");
+		expectRange(allocator.allocate(40), 0, 40, "The whole capacity after merging");
+
+		allocator.init(30);
+		for (size_t i = 0; i < 3; ++i) {
+			ranges[i] = *allocator.allocate(10);
+		}
+		allocator.free(ranges[0]);
+		allocator.free(ranges[1]);
+		expectState(allocator, 20, 1, "Merged with the previous neighbour");
+		expectRange(allocator.allocate(20), 0, 20, "The block merged with its previous neighbour");
+	}
+
+	// frees equal ranges in every order, the free blocks must always be the runs of freed ranges.
+	auto checkFreeOrders() -> void
+	{
+		constexpr size_t range_count = 6;
+		std::array<size_t, range_count> order;
+		for (size_t i = 0; i < range_count; ++i) {
+			order[i] = i;
+		}
+		do {
+			BufferAllocator allocator;
+			allocator.init(range_count * 8);
+			std::array<BufferAllocator::Range, range_count> ranges;
+			for (BufferAllocator::Range& range : ranges) {
+				range = *allocator.allocate(8);
+			}
+			std::array<bool, range_count> is_free{};
+			for (size_t i : order) {
+				allocator.free(ranges[i]);
+				is_free[i] = true;
+				size_t runs = 0;
+				for (size_t j = 0; j < range_count; ++j) {
+					runs += is_free[j] && (j == 0 || !is_free[j - 1]);
+				}
+				const auto freed = static_cast<uint32_t>(std::ranges::count(is_free, true) * 8);
+				if (allocator.getFreeSize() != freed || allocator.getFreeBlockCount() != runs) {
+					expectState(allocator, freed, runs, "After freeing range " + std::to_string(i) + " of some order");
+					return;
+				}
+			}
+		} while (std::ranges::next_permutation(order).found);
+	}
+
+	// random allocations and frees checked against which units are in use.
+	auto checkAgainstModel() -> void
+	{
+		constexpr uint32_t capacity = 512;
+		std::mt19937 random(7);
+		BufferAllocator allocator;
+		allocator.init(capacity);
+		std::vector<bool> is_used(capacity, false);
+		std::vector<BufferAllocator::Range> live;
+
+		// the free runs of the model, as (size, offset) so the smallest and then lowest comes first.
+		auto freeRuns = [&]() {
+			std::vector<std::pair<uint32_t, uint32_t>> runs;
+			for (uint32_t i = 0; i < capacity;) {
+				if (is_used[i]) {
+					++i;
+					continue;
+				}
+				uint32_t end = i;
+				while (end < capacity && !is_used[end]) {
+					++end;
+				}
+				runs.emplace_back(end - i, i);
+				i = end;
+			}
+			std::ranges::sort(runs);
+			return runs;
+		};
+
+		for (size_t step = 0; step < 20000; ++step) {
+			const bool should_allocate = live.empty() || random() % 100 < 55;
+			if (should_allocate) {
+				const uint32_t size = 1 + random() % 48;
+				const auto runs = freeRuns();
+				const auto fit = std::ranges::lower_bound(runs, std::pair<uint32_t, uint32_t>{ size, 0 });
+				const auto range = allocator.allocate(size);
+				if (fit == runs.end()) {
+					expect(!range, "A range was handed out with no free block large enough.");
+					if (range) {
+						return;
+					}
+					continue;
+				}
+				expectRange(range, fit->second, size, "Best fit against the model");
+				if (!range) {
+					return;
+				}
+				for (uint32_t i = range->offset; i < range->offset + range->size; ++i) {
+					is_used[i] = true;
+				}
+				live.emplace_back(*range);
+			}
+			else {
+				const size_t index = random() % live.size();
+				const BufferAllocator::Range range = live[index];
+				live[index] = live.back();
+				live.pop_back();
+				allocator.free(range);
+				for (uint32_t i = range.offset; i < range.offset + range.size; ++i) {
+					is_used[i] = false;
+				}
+			}
+
+			const auto free_size = static_cast<uint32_t>(std::ranges::count(is_used, false));
+			if (allocator.getFreeSize() != free_size || allocator.getFreeBlockCount() != freeRuns().size()) {
+				expectState(allocator, free_size, freeRuns().size(), "Step " + std::to_string(step) + " against the model");
+				return;
+			}
+		}
+	}
+
+	// each of these must stop a debug build, they are run as separate tests that are expected to fail.
+	// release builds don't check frees, so they skip the test instead.
+	constexpr int skipped = 77;
+
+	auto misuse(std::string_view name) -> int
+	{
+		if constexpr (BuildSettings::mode == BuildSettings::Mode::release) {
+			return skipped;
+		}
+		BufferAllocator allocator;
+		allocator.init(64);
+		const auto a = allocator.allocate(16);
+		const auto b = allocator.allocate(16);
+		if (name == "double_free") {
+			allocator.free(*a);
+			allocator.free(*a);
+		}
+		else if (name == "overlapping_free") {
+			allocator.free(*a);
+			allocator.free({ a->offset + 8, 16 });
+		}
+		else if (name == "out_of_range_free") {
+			allocator.free({ 60, 8 });
+		}
+		else {
+			std::cerr << "Unknown misuse \"" << name << "\".\n";
+			return EXIT_SUCCESS;
+		}
+		allocator.free(*b);
+		std::cerr << "The allocator let \"" << name << "\" through.\n";
+		return EXIT_SUCCESS;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 1) {
+		return misuse(argv[1]);
+	}
+
+	checkEmptyAndZeroSize();
+	checkExactFit();
+	checkBestFit();
+	checkMerges();
+	checkFreeOrders();
+	checkAgainstModel();
+
+	if (failures != 0) {
+		std::cerr << failures << " allocator checks failed.\n";
+		return EXIT_FAILURE;
+	}
+	std::cout << "Every allocator check passed.\n";
+	return EXIT_SUCCESS;
+}
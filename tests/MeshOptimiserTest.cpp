@@ -0,0 +1,118 @@
+// Checks that MeshOptimiser's passes only reorder what is drawn, and that they never make the vertex cache do worse.
+// Reads the sample objs from assets/objects, so it runs from the build directory.
+#include "renderer/3d/MeshOptimiser.hpp"
+#include "SampleMeshes.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+	uint64_t failures = 0;
+
+	auto expect(bool condition, std::string_view what) -> void
+	{
+		if (!condition) {
+			++failures;
+			std::cerr << what << '\n';
+		}
+	}
+
+	// every triangle as the floats of its three vertices, rotated to start at the smallest so the winding is kept.
+	// comparing the sorted lists compares the multisets of drawn triangles, whatever the indices and their order.
+	auto drawnTriangles(std::span<const uint32_t> indices, std::span<const float> vertex_data, size_t floats_per_vertex) -> std::vector<std::vector<float>>
+	{
+		std::vector<std::vector<float>> triangles;
+		triangles.reserve(indices.size() / 3);
+		for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+			std::array<std::span<const float>, 3> corners;
+			for (size_t corner = 0; corner < 3; ++corner) {
+				corners[corner] = vertex_data.subspan(indices[i + corner] * floats_per_vertex, floats_per_vertex);
+			}
+			const size_t first = std::ranges::min_element(corners, std::ranges::lexicographical_compare) - corners.begin();
+			std::vector<float>& triangle = triangles.emplace_back();
+			for (size_t corner = 0; corner < 3; ++corner) {
+				const std::span<const float> vertex = corners[(first + corner) % 3];
+				triangle.insert(triangle.end(), vertex.begin(), vertex.end());
+			}
+		}
+		std::ranges::sort(triangles);
+		return triangles;
+	}
+
+	auto checkMesh(const SampleMesh& sample) -> void
+	{
+		const size_t stride = sample.floats_per_vertex;
+		const size_t vertex_count = sample.getVertexCount();
+		const std::vector<std::vector<float>> expected = drawnTriangles(sample.indices, sample.vertex_data, stride);
+		std::vector<uint32_t> indices = sample.indices;
+		std::vector<float> vertex_data = sample.vertex_data;
+
+		auto expectSameTriangles = [&](std::string_view pass) {
+			expect(drawnTriangles(indices, vertex_data, stride) == expected, sample.name + ": " + std::string{ pass } + " changed the triangles drawn.");
+		};
+
+		const MeshOptimiser::VertexCacheStatistics before = MeshOptimiser::analyseVertexCache(indices, vertex_count);
+
+		MeshOptimiser::optimiseVertexCache(indices, vertex_count);
+		expectSameTriangles("optimiseVertexCache");
+		const MeshOptimiser::VertexCacheStatistics after_cache = MeshOptimiser::analyseVertexCache(indices, vertex_count);
+		expect(after_cache.acmr <= before.acmr, sample.name + ": optimiseVertexCache raised the acmr from " + std::to_string(before.acmr) + " to " + std::to_string(after_cache.acmr) + ".");
+
+		MeshOptimiser::optimiseOverdraw(indices, vertex_data, stride);
+		expectSameTriangles("optimiseOverdraw");
+		const MeshOptimiser::VertexCacheStatistics after_overdraw = MeshOptimiser::analyseVertexCache(indices, vertex_count);
+		// the overdraw pass may give back up to its threshold of the cache gains, but never more.
+		constexpr float default_threshold = 1.05f;
+		expect(after_overdraw.acmr <= after_cache.acmr * default_threshold + 1e-4f, sample.name + ": optimiseOverdraw gave back more than its threshold of the acmr, " + std::to_string(after_cache.acmr) + " -> " + std::to_string(after_overdraw.acmr) + ".");
+
+		MeshOptimiser::optimiseVertexFetch(indices, vertex_data, stride);
+		expectSameTriangles("optimiseVertexFetch");
+		const MeshOptimiser::VertexCacheStatistics after_fetch = MeshOptimiser::analyseVertexCache(indices, vertex_count);
+		expect(after_fetch.vertices_transformed == after_overdraw.vertices_transformed, sample.name + ": optimiseVertexFetch changed the cache behaviour, it should only rename vertices.");
+		// the vertices are numbered in the order the triangles first use them.
+		uint32_t next_new_vertex = 0;
+		bool is_first_use_order = true;
+		for (uint32_t index : indices) {
+			if (index == next_new_vertex) {
+				++next_new_vertex;
+			}
+			is_first_use_order &= index < next_new_vertex;
+		}
+		expect(is_first_use_order, sample.name + ": optimiseVertexFetch didn't number the vertices in the order they are first used.");
+
+		expect(after_fetch.acmr <= before.acmr, sample.name + ": optimising raised the acmr from " + std::to_string(before.acmr) + " to " + std::to_string(after_fetch.acmr) + ".");
+		std::cout << sample.name << ": " << before.triangle_count << " triangles, acmr " << before.acmr << " -> " << after_fetch.acmr << '\n';
+	}
+}
+
+int main()
+{
+	std::vector<SampleMesh> samples;
+	expect(SampleMeshes::all(samples), "Not every sample mesh could be read.");
+	for (const SampleMesh& sample : samples) {
+		checkMesh(sample);
+	}
+
+	// the shuffled sphere starts with next to no reuse, the optimiser should find plenty.
+	{
+		SampleMesh sphere = SampleMeshes::bumpySphere(48, 96);
+		const float before = MeshOptimiser::analyseVertexCache(sphere.indices, sphere.getVertexCount()).acmr;
+		MeshOptimiser::optimiseVertexCache(sphere.indices, sphere.getVertexCount());
+		const float after = MeshOptimiser::analyseVertexCache(sphere.indices, sphere.getVertexCount()).acmr;
+		expect(after < 0.8f && after < before * 0.5f, "The shuffled sphere's acmr only went from " + std::to_string(before) + " to " + std::to_string(after) + ".");
+	}
+
+	if (failures != 0) {
+		std::cerr << failures << " optimiser checks failed.\n";
+		return EXIT_FAILURE;
+	}
+	std::cout << "Every optimiser pass kept the triangles and the acmr.\n";
+	return EXIT_SUCCESS;
+}
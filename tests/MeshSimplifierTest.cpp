@@ -0,0 +1,237 @@
+// Checks MeshSimplifier's levels of detail: each level has no more triangles than the one before and no more than
+// its ratio asks for, and no vertex of the full mesh ends up further than max_error from the simplified surface.
+// Reads the sample objs from assets/objects, so it runs from the build directory.
+#include "renderer/3d/MeshSimplifier.hpp"
+#include "SampleMeshes.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+	uint64_t failures = 0;
+
+	auto expect(bool condition, std::string_view what) -> void
+	{
+		if (!condition) {
+			++failures;
+			std::cerr << what << '\n';
+		}
+	}
+
+	auto positionOf(const SampleMesh& mesh, uint32_t vertex) -> glm::dvec3
+	{
+		const float* p = mesh.vertex_data.data() + vertex * mesh.floats_per_vertex;
+		return { p[0], p[1], p[2] };
+	}
+
+	// the closest point on the triangle to p, from Ericson's Real-Time Collision Detection.
+	auto distanceToTriangle(glm::dvec3 p, glm::dvec3 a, glm::dvec3 b, glm::dvec3 c) -> double
+	{
+		const glm::dvec3 ab = b - a;
+		const glm::dvec3 ac = c - a;
+		const glm::dvec3 ap = p - a;
+		const double d1 = glm::dot(ab, ap);
+		const double d2 = glm::dot(ac, ap);
+		if (d1 <= 0 && d2 <= 0) {
+			return glm::length(p - a);
+		}
+		const glm::dvec3 bp = p - b;
+		const double d3 = glm::dot(ab, bp);
+		const double d4 = glm::dot(ac, bp);
+		if (d3 >= 0 && d4 <= d3) {
+			return glm::length(p - b);
+		}
+		const double vc = d1 * d4 - d3 * d2;
+		if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+			return glm::length(p - (a + ab * (d1 / (d1 - d3))));
+		}
+		const glm::dvec3 cp = p - c;
+		const double d5 = glm::dot(ab, cp);
+		const double d6 = glm::dot(ac, cp);
+		if (d6 >= 0 && d5 <= d6) {
+			return glm::length(p - c);
+		}
+		const double vb = d5 * d2 - d1 * d6;
+		if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+			return glm::length(p - (a + ac * (d2 / (d2 - d6))));
+		}
+		const double va = d3 * d6 - d5 * d4;
+		if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+			return glm::length(p - (b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)))));
+		}
+		const double denominator = 1.0 / (va + vb + vc);
+		return glm::length(p - (a + ab * (vb * denominator) + ac * (vc * denominator)));
+	}
+
+	// Buckets a level's triangles in a grid of cells as wide as the allowed error, so only the triangles near a
+	// vertex need measuring to know whether it is within that distance of the level.
+	class TriangleGrid {
+		const SampleMesh& m_mesh;
+		std::span<const uint32_t> m_indices;
+		glm::dvec3 m_origin;
+		double m_cell_size;
+		std::unordered_map<uint64_t, std::vector<uint32_t>> m_cells;
+
+		auto cellOf(glm::dvec3 p) const -> glm::ivec3
+		{
+			const glm::dvec3 cell = (p - m_origin) / m_cell_size;
+			return { static_cast<int>(std::floor(cell.x)), static_cast<int>(std::floor(cell.y)), static_cast<int>(std::floor(cell.z)) };
+		}
+
+		static auto keyOf(int x, int y, int z) -> uint64_t
+		{
+			return (static_cast<uint64_t>(static_cast<uint32_t>(x) & 0x1FFFFF) << 42)
+				| (static_cast<uint64_t>(static_cast<uint32_t>(y) & 0x1FFFFF) << 21)
+				| (static_cast<uint64_t>(static_cast<uint32_t>(z) & 0x1FFFFF));
+		}
+
+	public:
+		TriangleGrid(const SampleMesh& mesh, std::span<const uint32_t> indices, glm::dvec3 origin, double cell_size)
+			: m_mesh(mesh)
+			, m_indices(indices)
+			, m_origin(origin)
+			, m_cell_size(cell_size)
+		{
+			for (uint32_t triangle = 0; triangle < indices.size() / 3; ++triangle) {
+				const glm::dvec3 a = positionOf(mesh, indices[triangle * 3 + 0]);
+				const glm::dvec3 b = positionOf(mesh, indices[triangle * 3 + 1]);
+				const glm::dvec3 c = positionOf(mesh, indices[triangle * 3 + 2]);
+				const glm::ivec3 low = cellOf(glm::min(glm::min(a, b), c));
+				const glm::ivec3 high = cellOf(glm::max(glm::max(a, b), c));
+				for (int x = low.x; x <= high.x; ++x) {
+					for (int y = low.y; y <= high.y; ++y) {
+						for (int z = low.z; z <= high.z; ++z) {
+							m_cells[keyOf(x, y, z)].emplace_back(triangle);
+						}
+					}
+				}
+			}
+		}
+
+		// the distance to the closest triangle, or infinity when none is within a cell size.
+		auto distanceTo(glm::dvec3 p) const -> double
+		{
+			double closest = std::numeric_limits<double>::infinity();
+			const glm::ivec3 centre = cellOf(p);
+			for (int x = centre.x - 1; x <= centre.x + 1; ++x) {
+				for (int y = centre.y - 1; y <= centre.y + 1; ++y) {
+					for (int z = centre.z - 1; z <= centre.z + 1; ++z) {
+						const auto cell = m_cells.find(keyOf(x, y, z));
+						if (cell == m_cells.end()) {
+							continue;
+						}
+						for (uint32_t triangle : cell->second) {
+							const double distance = distanceToTriangle(p,
+								positionOf(m_mesh, m_indices[triangle * 3 + 0]),
+								positionOf(m_mesh, m_indices[triangle * 3 + 1]),
+								positionOf(m_mesh, m_indices[triangle * 3 + 2]));
+							closest = std::min(closest, distance);
+						}
+					}
+				}
+			}
+			return closest <= m_cell_size ? closest : std::numeric_limits<double>::infinity();
+		}
+	};
+
+	// returns how many levels were built, so callers can tell the chain wasn't trivially empty.
+	auto checkChain(const SampleMesh& sample, float max_error) -> size_t
+	{
+		const std::string label = sample.name + " at max error " + std::to_string(max_error) + ": ";
+		const size_t triangle_count = sample.indices.size() / 3;
+		const std::vector<std::vector<uint32_t>> lods = MeshSimplifier::buildLodChain(sample.indices, sample.vertex_data, sample.floats_per_vertex, MeshSimplifier::lod_ratios, max_error);
+
+		expect(lods.size() <= MeshSimplifier::lod_ratios.size(), label + "more levels than ratios.");
+		if (triangle_count < MeshSimplifier::min_triangle_count) {
+			expect(lods.empty(), label + "levels for a mesh below the minimum triangle count.");
+			return lods.size();
+		}
+
+		glm::dvec3 bounds_min = positionOf(sample, 0);
+		glm::dvec3 bounds_max = bounds_min;
+		for (uint32_t vertex = 0; vertex < sample.getVertexCount(); ++vertex) {
+			bounds_min = glm::min(bounds_min, positionOf(sample, vertex));
+			bounds_max = glm::max(bounds_max, positionOf(sample, vertex));
+		}
+		const glm::dvec3 extent = bounds_max - bounds_min;
+		const double allowed_distance = max_error * std::max({ extent.x, extent.y, extent.z });
+
+		// the vertices the full mesh draws, the ones that have to stay close to every level.
+		std::vector<uint32_t> used_vertices(sample.indices.begin(), sample.indices.end());
+		std::ranges::sort(used_vertices);
+		used_vertices.erase(std::unique(used_vertices.begin(), used_vertices.end()), used_vertices.end());
+
+		size_t previous_count = triangle_count;
+		for (size_t level = 0; level < lods.size(); ++level) {
+			const std::string level_label = label + "level " + std::to_string(level + 1) + " ";
+			const std::vector<uint32_t>& indices = lods[level];
+			const size_t count = indices.size() / 3;
+			expect(indices.size() % 3 == 0, level_label + "isn't a list of triangles.");
+			expect(count <= previous_count, level_label + "has " + std::to_string(count) + " triangles, more than the " + std::to_string(previous_count) + " before it.");
+			const auto target = static_cast<size_t>(triangle_count * MeshSimplifier::lod_ratios[level]);
+			expect(count <= target, level_label + "has " + std::to_string(count) + " triangles, more than its ratio's " + std::to_string(target) + ".");
+			previous_count = count;
+
+			bool is_valid = true;
+			for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+				is_valid &= indices[i] < sample.getVertexCount() && indices[i + 1] < sample.getVertexCount() && indices[i + 2] < sample.getVertexCount();
+				is_valid &= indices[i] != indices[i + 1] && indices[i + 1] != indices[i + 2] && indices[i + 2] != indices[i];
+			}
+			expect(is_valid, level_label + "has out of range or collapsed triangles.");
+			if (!is_valid) {
+				continue;
+			}
+
+			const TriangleGrid grid(sample, indices, bounds_min, allowed_distance);
+			double worst = 0;
+			size_t too_far = 0;
+			for (uint32_t vertex : used_vertices) {
+				const double distance = grid.distanceTo(positionOf(sample, vertex));
+				too_far += distance > allowed_distance;
+				if (std::isfinite(distance)) {
+					worst = std::max(worst, distance);
+				}
+			}
+			expect(too_far == 0, level_label + "leaves " + std::to_string(too_far) + " vertices further than " + std::to_string(allowed_distance) + " from its surface.");
+			std::cout << level_label << count << " triangles, furthest vertex " << worst / allowed_distance << " of the max error away\n";
+		}
+		return lods.size();
+	}
+}
+
+int main()
+{
+	std::vector<SampleMesh> samples;
+	expect(SampleMeshes::all(samples), "Not every sample mesh could be read.");
+	for (const SampleMesh& sample : samples) {
+		checkChain(sample, MeshSimplifier::max_relative_error);
+		// a tighter bound stops the chain sooner, but what it does build must still hold to it.
+		checkChain(sample, MeshSimplifier::max_relative_error * 0.1f);
+	}
+
+	// smooth closed meshes have plenty to collapse, the chain should reach its coarsest ratio.
+	const SampleMesh sphere = SampleMeshes::bumpySphere(48, 96);
+	expect(checkChain(sphere, MeshSimplifier::max_relative_error) == MeshSimplifier::lod_ratios.size(), "The bumpy sphere didn't simplify to every ratio.");
+	// below the minimum there's nothing to build.
+	const SampleMesh small_sphere = SampleMeshes::bumpySphere(6, 12);
+	expect(checkChain(small_sphere, MeshSimplifier::max_relative_error) == 0, "A mesh below the minimum triangle count was simplified.");
+
+	if (failures != 0) {
+		std::cerr << failures << " simplifier checks failed.\n";
+		return EXIT_FAILURE;
+	}
+	std::cout << "Every level of detail kept to its ratio and its error.\n";
+	return EXIT_SUCCESS;
+}
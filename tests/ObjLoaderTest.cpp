@@ -0,0 +1,257 @@
+// Checks that parsing an obj in parallel chunks gives exactly the meshes the serial parse does.
+// The generated obj is several megabytes so that the loader really splits it, with every line the same width so
+// the test can tell where the chunks start and place objects, vertex runs and relative faces around those points.
+#include "renderer/3d/Mesh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace {
+	// every line is padded to this many characters, the newline included.
+	constexpr size_t line_width = 96;
+	constexpr size_t line_count = 100'000;
+	// the loader gives each thread at least a megabyte, so this parses on up to nine threads.
+	static_assert(line_width * line_count >= 9 * 1024 * 1024);
+	// objects start on the first line of the chunks of one thread count, and on the last line of the chunks of another.
+	constexpr size_t objects_first_thread_count = 4;
+	constexpr size_t objects_last_thread_count = 3;
+	constexpr std::array thread_counts = { size_t{ 2 }, objects_last_thread_count, objects_first_thread_count, size_t{ 7 }, size_t{ 9 } };
+
+	uint64_t failures = 0;
+
+	auto expect(bool condition, const std::string& what) -> void
+	{
+		if (!condition) {
+			++failures;
+			std::cerr << what << '\n';
+		}
+	}
+
+	// the first line of every chunk the loader splits line_count lines into, mirroring splitIntoChunks.
+	auto chunkStarts(size_t chunk_count) -> std::vector<size_t>
+	{
+		const size_t size = line_width * line_count;
+		const size_t target_size = size / chunk_count;
+		std::vector<size_t> starts;
+		size_t begin = 0;
+		while (begin != size) {
+			starts.emplace_back(begin / line_width);
+			const size_t split = (size - begin > target_size) ? begin + target_size : size - 1;
+			// the newline at or after split, then the start of the next line.
+			begin = (split / line_width + 1) * line_width;
+		}
+		return starts;
+	}
+
+	enum class LineKind { object, vertex, uv, normal, face };
+
+	struct GeneratedObj {
+		std::string text;
+		std::vector<LineKind> kinds;
+		// for each face line, the first line of every element it refers to.
+		std::vector<std::vector<size_t>> face_references;
+		size_t object_count = 0;
+		size_t face_count = 0;
+	};
+
+	auto generateObj() -> GeneratedObj
+	{
+		GeneratedObj obj;
+		obj.kinds.reserve(line_count);
+		obj.face_references.resize(line_count);
+		std::vector<size_t> object_lines = chunkStarts(objects_first_thread_count);
+		for (size_t start : chunkStarts(objects_last_thread_count)) {
+			if (start != 0) {
+				object_lines.emplace_back(start - 1);
+			}
+		}
+
+		// where each element was defined, to know what a relative index reaches back to.
+		std::vector<size_t> vertex_lines;
+		std::vector<size_t> uv_lines;
+		std::vector<size_t> normal_lines;
+		// runs of 12 vertices, 4 uvs, 4 normals then 20 faces, long enough for chunks to start inside each run.
+		constexpr std::array pattern_runs = { LineKind::vertex, LineKind::uv, LineKind::normal, LineKind::face };
+		constexpr std::array<size_t, 4> pattern_lengths = { 12, 4, 4, 20 };
+		size_t run = 0;
+		size_t run_position = 0;
+		uint32_t seed = 12345;
+		auto random = [&]() {
+			seed = seed * 1664525u + 1013904223u;
+			return seed >> 8;
+		};
+
+		std::array<char, line_width> line;
+		for (size_t i = 0; i < line_count; ++i) {
+			LineKind kind;
+			if (std::ranges::find(object_lines, i) != object_lines.end()) {
+				kind = LineKind::object;
+			}
+			else {
+				kind = pattern_runs[run];
+				if (++run_position == pattern_lengths[run]) {
+					run_position = 0;
+					run = (run + 1) % pattern_runs.size();
+				}
+			}
+
+			int length = 0;
+			auto coordinate = [&]() { return static_cast<float>(random() % 20000) / 10000.0f - 1.0f; };
+			switch (kind) {
+			case LineKind::object:
+				length = std::snprintf(line.data(), line.size(), "o part_%zu", obj.object_count++);
+				break;
+			case LineKind::vertex:
+				vertex_lines.emplace_back(i);
+				length = std::snprintf(line.data(), line.size(), "v %.5f %.5f %.5f", coordinate(), coordinate(), coordinate());
+				break;
+			case LineKind::uv:
+				uv_lines.emplace_back(i);
+				length = std::snprintf(line.data(), line.size(), "vt %.5f %.5f", coordinate(), coordinate());
+				break;
+			case LineKind::normal:
+				normal_lines.emplace_back(i);
+				length = std::snprintf(line.data(), line.size(), "vn %.5f %.5f %.5f", coordinate(), coordinate(), coordinate());
+				break;
+			case LineKind::face: {
+				++obj.face_count;
+				length = std::snprintf(line.data(), line.size(), "f");
+				// mostly relative indices reaching up to a few hundred elements back, with some absolute ones mixed in.
+				auto index = [&](const std::vector<size_t>& defined) -> int64_t {
+					const size_t back = 1 + random() % std::min<size_t>(defined.size(), 400);
+					obj.face_references[i].emplace_back(defined[defined.size() - back]);
+					const bool is_absolute = random() % 5 == 0;
+					return is_absolute ? static_cast<int64_t>(defined.size() - back + 1) : -static_cast<int64_t>(back);
+				};
+				for (size_t corner = 0; corner < 3; ++corner) {
+					const int64_t v = index(vertex_lines);
+					const int64_t vt = index(uv_lines);
+					const int64_t vn = index(normal_lines);
+					length += std::snprintf(line.data() + length, line.size() - length, " %lld/%lld/%lld", static_cast<long long>(v), static_cast<long long>(vt), static_cast<long long>(vn));
+				}
+				break;
+			}
+			}
+			if (length <= 0 || static_cast<size_t>(length) >= line_width) {
+				std::cerr << "Line " << i << " doesn't fit in " << line_width << " characters.\n";
+				std::exit(EXIT_FAILURE);
+			}
+			std::fill(line.begin() + length, line.end() - 1, ' ');
+			line.back() = '\n';
+			obj.text.append(line.data(), line.size());
+			obj.kinds.emplace_back(kind);
+		}
+		return obj;
+	}
+
+	// makes sure the generated obj puts chunk boundaries where they are hard to get right, so it keeps testing them.
+	auto checkCoverage(const GeneratedObj& obj) -> void
+	{
+		size_t objects_starting_chunks = 0;
+		size_t objects_ending_chunks = 0;
+		size_t boundaries_inside_vertex_runs = 0;
+		size_t boundaries_inside_face_runs = 0;
+		size_t faces_reaching_back = 0;
+		for (size_t thread_count : thread_counts) {
+			const std::vector<size_t> starts = chunkStarts(thread_count);
+			for (size_t chunk = 1; chunk < starts.size(); ++chunk) {
+				const size_t start = starts[chunk];
+				objects_starting_chunks += obj.kinds[start] == LineKind::object;
+				objects_ending_chunks += obj.kinds[start - 1] == LineKind::object;
+				boundaries_inside_vertex_runs += obj.kinds[start - 1] == LineKind::vertex && obj.kinds[start] == LineKind::vertex;
+				boundaries_inside_face_runs += obj.kinds[start - 1] == LineKind::face && obj.kinds[start] == LineKind::face;
+
+				const size_t end = (chunk + 1 < starts.size()) ? starts[chunk + 1] : line_count;
+				for (size_t i = start; i < end; ++i) {
+					faces_reaching_back += std::ranges::any_of(obj.face_references[i], [&](size_t line) { return line < start; });
+				}
+			}
+		}
+		expect(objects_starting_chunks >= chunkStarts(objects_first_thread_count).size() - 1, "Too few chunks start with an object.");
+		expect(objects_ending_chunks >= chunkStarts(objects_last_thread_count).size() - 1, "Too few chunks end with an object.");
+		expect(boundaries_inside_vertex_runs != 0, "No chunk starts inside a run of vertices.");
+		expect(boundaries_inside_face_runs != 0, "No chunk starts inside a run of faces.");
+		expect(faces_reaching_back != 0, "No face refers back past the start of its chunk.");
+	}
+
+	auto compareMeshes(const std::vector<MeshVariant>& serial, const std::vector<MeshVariant>& parallel, size_t thread_count) -> void
+	{
+		const std::string label = "With " + std::to_string(thread_count) + " threads, ";
+		if (serial.size() != parallel.size()) {
+			expect(false, label + "there are " + std::to_string(parallel.size()) + " meshes instead of " + std::to_string(serial.size()) + ".");
+			return;
+		}
+		for (size_t i = 0; i < serial.size(); ++i) {
+			const std::string mesh_label = label + "mesh " + std::to_string(i) + " ";
+			if (serial[i].index() != parallel[i].index()) {
+				expect(false, mesh_label + "has another layout.");
+				continue;
+			}
+			std::visit([&](const auto& expected) {
+				const auto& mesh = std::get<std::decay_t<decltype(expected)>>(parallel[i]);
+				expect(mesh.num_faces == expected.num_faces, mesh_label + "has another face count.");
+				expect(mesh.vertex_buffer_data == expected.vertex_buffer_data, mesh_label + "has other vertices.");
+				expect(mesh.index_buffer_data == expected.index_buffer_data, mesh_label + "has other indices.");
+				expect(mesh.bounds_min == expected.bounds_min && mesh.bounds_max == expected.bounds_max, mesh_label + "has other bounds.");
+			}, serial[i]);
+		}
+	}
+}
+
+int main()
+{
+	const GeneratedObj obj = generateObj();
+	checkCoverage(obj);
+
+	const std::filesystem::path obj_path = std::filesystem::temp_directory_path() / "ObjLoaderTest.obj";
+	{
+		std::ofstream outfile(obj_path, std::ios::binary | std::ios::trunc);
+		outfile.write(obj.text.data(), static_cast<std::streamsize>(obj.text.size()));
+		if (!outfile.good()) {
+			std::cerr << "Failed to write " << obj_path << ".\n";
+			return EXIT_FAILURE;
+		}
+	}
+
+	auto serial = MeshLoader::parseObj(obj_path, 1);
+	if (serial.HasError()) {
+		std::cerr << "The serial parse failed: " << serial.Error() << '\n';
+		return EXIT_FAILURE;
+	}
+	// every object has faces, and every face has all three attributes.
+	expect(serial.Value().size() == obj.object_count, "The serial parse has " + std::to_string(serial.Value().size()) + " meshes instead of " + std::to_string(obj.object_count) + ".");
+	size_t face_count = 0;
+	for (const MeshVariant& mesh_variant : serial.Value()) {
+		expect(std::holds_alternative<Mesh<MeshType::positions_normals_uvs>>(mesh_variant), "The serial parse dropped an attribute.");
+		std::visit([&](const auto& mesh) { face_count += mesh.num_faces; }, mesh_variant);
+	}
+	expect(face_count == obj.face_count, "The serial parse has " + std::to_string(face_count) + " faces instead of " + std::to_string(obj.face_count) + ".");
+
+	for (size_t thread_count : thread_counts) {
+		auto parallel = MeshLoader::parseObj(obj_path, thread_count);
+		if (parallel.HasError()) {
+			expect(false, "The parse with " + std::to_string(thread_count) + " threads failed: " + std::string{ parallel.Error() });
+			continue;
+		}
+		compareMeshes(serial.Value(), parallel.Value(), thread_count);
+	}
+
+	std::error_code error;
+	std::filesystem::remove(obj_path, error);
+
+	if (failures != 0) {
+		std::cerr << failures << " differences between the serial and parallel parses.\n";
+		return EXIT_FAILURE;
+	}
+	std::cout << "Every parallel parse matched the serial one.\n";
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,178 @@
+// Checks wm::parse against std::from_chars, exhaustively for floats printed shortest.
+// Run without arguments for every finite float, or with a stride, e.g. `ParsersTest 97`, for a quicker sample.
+#include <wm/Parsers.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace {
+	std::atomic<uint64_t> failures = 0;
+
+	auto fromChars(std::string_view text) -> float
+	{
+		// from_chars doesn't take a leading plus, wm::parse does.
+		if (text.starts_with('+')) {
+			text.remove_prefix(1);
+		}
+		float value = 0.0f;
+		const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+		if (result.ec == std::errc::result_out_of_range) {
+			// from_chars leaves value alone when out of range, wm::parse rounds to zero or infinity.
+			const bool is_negative = text.starts_with('-');
+			const bool is_tiny = text.find("e-") != std::string_view::npos;
+			value = is_tiny ? 0.0f : std::numeric_limits<float>::infinity();
+			value = is_negative ? -value : value;
+		}
+		return value;
+	}
+
+	auto expectFloat(std::string_view text) -> void
+	{
+		const float expected = fromChars(text);
+		const float parsed = wm::parse::toFloat(text);
+		if (std::bit_cast<uint32_t>(parsed) != std::bit_cast<uint32_t>(expected)) {
+			if (failures++ < 20) {
+				std::cerr << "toFloat(\"" << text << "\") gave " << std::bit_cast<uint32_t>(parsed) << ", expected " << std::bit_cast<uint32_t>(expected) << '\n';
+			}
+		}
+	}
+
+	auto expectInt(std::string_view text, int32_t expected) -> void
+	{
+		const int32_t parsed = wm::parse::toInt(text);
+		if (parsed != expected) {
+			++failures;
+			std::cerr << "toInt(\"" << text << "\") gave " << parsed << ", expected " << expected << '\n';
+		}
+	}
+
+	// every finite float from first in steps of stride, printed shortest in both general and fixed notation.
+	auto checkShortest(uint64_t first, uint64_t stride) -> void
+	{
+		std::array<char, 128> buffer;
+		for (uint64_t bits = first; bits <= UINT32_MAX; bits += stride) {
+			const float value = std::bit_cast<float>(static_cast<uint32_t>(bits));
+			if (!std::isfinite(value)) {
+				continue;
+			}
+			auto end = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value).ptr;
+			expectFloat({ buffer.data(), end });
+			if ((bits & 0xFF) == 0) {
+				end = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value, std::chars_format::fixed).ptr;
+				expectFloat({ buffer.data(), end });
+			}
+		}
+	}
+
+	// The exact halfway points between neighbouring floats, which need every digit to round to even, and
+	// points just either side of them, which differ from it only past the 19th digit.
+	auto checkHalfways(uint32_t stride) -> void
+	{
+		std::array<char, 1024> buffer;
+		for (uint64_t bits = 0; bits < 0x7F800000; bits += stride) {
+			const double lower = std::bit_cast<float>(static_cast<uint32_t>(bits));
+			const double upper = std::bit_cast<float>(static_cast<uint32_t>(bits + 1));
+			// exact, a double holds the halfway point's 25 significant bits.
+			const double halfway = lower + (upper - lower) / 2.0;
+			auto end = std::to_chars(buffer.data(), buffer.data() + buffer.size(), halfway, std::chars_format::scientific, 120).ptr;
+			const auto text = std::string { buffer.data(), end };
+			expectFloat(text);
+
+			const size_t exponent_begin = text.find('e');
+			std::string mantissa = text.substr(0, exponent_begin);
+			const std::string exponent = text.substr(exponent_begin);
+			mantissa.erase(mantissa.find_last_not_of('0') + 1);
+			expectFloat(mantissa + "1" + exponent);
+			expectFloat(mantissa + "000000000000000000000000001" + exponent);
+			expectFloat("-" + mantissa + "1" + exponent);
+			for (size_t digits : { 20, 21, 25, 40 }) {
+				if (mantissa.size() > digits + 1) {
+					expectFloat(mantissa.substr(0, digits + 1) + exponent);
+				}
+			}
+		}
+	}
+
+	auto checkOddInputs() -> void
+	{
+		for (std::string_view text : { "0", "-0", "+0", "0.0", ".5", "5.", "-.5", "1e", "1e+", "1e-", "1e5", "1E5", "+1.5e-3", "1e-50", "-1e-50",
+				 "1e39", "-1e39", "3.4028235e38", "3.4028236e38", "1.17549435e-38", "1.4e-45", "7e-46", "7.1e-46",
+				 "340282356779733661637539395458142568448", "340282356779733661637539395458142568447",
+				 "0.000000000000000000000000000000000000000000001401298464324817070923729583289916131280",
+				 "1.00000005960464477539062500000000000000000000000000000000000000000000000000000000000000001",
+				 "1.000000059604644775390625", "1.00000005960464477539062499999999999999999999999999999999999",
+				 "123456789012345678901234567890", "0.000000000000000000000000000000000000001234567890123456789012345" }) {
+			expectFloat(text);
+		}
+		// text that isn't a number at all parses as zero.
+		for (std::string_view text : { "", "-", "+", ".", "e5", "abc" }) {
+			if (std::bit_cast<uint32_t>(wm::parse::toFloat(text)) != 0) {
+				++failures;
+				std::cerr << "toFloat(\"" << text << "\") isn't zero\n";
+			}
+		}
+	}
+
+	auto checkInts() -> void
+	{
+		expectInt("", 0);
+		expectInt("-", 0);
+		expectInt("+", 0);
+		expectInt("abc", 0);
+		expectInt("0", 0);
+		expectInt("-0", 0);
+		expectInt("+7", 7);
+		expectInt("-7", -7);
+		expectInt("12/34", 12);
+		expectInt("007", 7);
+		expectInt("2147483647", 2147483647);
+		expectInt("-2147483647", -2147483647);
+		expectInt("-2147483648", -2147483647 - 1);
+		// overflow wraps.
+		expectInt("2147483648", -2147483647 - 1);
+		expectInt("4294967296", 0);
+		expectInt("4294967297", 1);
+		for (int32_t value = -100000; value <= 100000; ++value) {
+			const std::string text = std::to_string(value);
+			expectInt(text, value);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const uint64_t stride = (argc > 1) ? std::max(std::strtoull(argv[1], nullptr, 10), 1ull) : 1;
+
+	checkInts();
+	checkOddInputs();
+	checkHalfways(static_cast<uint32_t>(std::max<uint64_t>(stride, 4099)));
+
+	// shortest printed floats, split between the hardware threads.
+	const uint64_t thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+	{
+		std::vector<std::jthread> threads;
+		for (uint64_t i = 0; i < thread_count; ++i) {
+			threads.emplace_back(checkShortest, i * stride, thread_count * stride);
+		}
+	}
+
+	if (failures != 0) {
+		std::cerr << failures << " values parsed differently to std::from_chars.\n";
+		return EXIT_FAILURE;
+	}
+	std::cout << "Every value parsed the same as std::from_chars.\n";
+	return EXIT_SUCCESS;
+}
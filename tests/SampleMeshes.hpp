@@ -0,0 +1,128 @@
+#pragma once
+
+// Indexed meshes for the mesh processing tests: generated ones with known shapes, and the repo's own objs,
+// which are read from assets/objects relative to the working directory.
+#include "renderer/3d/Mesh.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <numbers>
+#include <random>
+#include <string>
+#include <variant>
+#include <vector>
+
+struct SampleMesh {
+	std::string name;
+	size_t floats_per_vertex;
+	std::vector<float> vertex_data;
+	std::vector<uint32_t> indices;
+
+	auto getVertexCount() const -> size_t { return vertex_data.size() / floats_per_vertex; }
+};
+
+namespace SampleMeshes {
+	// a bumpy sphere of positions and normals, with a uv style seam and poles, its triangles shuffled so they
+	// start out in the worst order for the vertex cache.
+	inline auto bumpySphere(uint32_t rings, uint32_t segments) -> SampleMesh
+	{
+		SampleMesh mesh = { .name = "generated bumpy sphere", .floats_per_vertex = 6 };
+		for (uint32_t ring = 0; ring <= rings; ++ring) {
+			const float theta = std::numbers::pi_v<float> * ring / rings;
+			for (uint32_t segment = 0; segment <= segments; ++segment) {
+				const float phi = 2.0f * std::numbers::pi_v<float> * (segment % segments) / segments;
+				const float radius = 1.0f + 0.05f * std::sin(5.0f * theta) * std::sin(4.0f * phi);
+				const float x = std::sin(theta) * std::cos(phi);
+				const float y = std::cos(theta);
+				const float z = std::sin(theta) * std::sin(phi);
+				mesh.vertex_data.insert(mesh.vertex_data.end(), { radius * x, radius * y, radius * z, x, y, z });
+			}
+		}
+		const uint32_t row = segments + 1;
+		for (uint32_t ring = 0; ring < rings; ++ring) {
+			for (uint32_t segment = 0; segment < segments; ++segment) {
+				const uint32_t a = ring * row + segment;
+				const uint32_t b = a + row;
+				// the quads touching a pole have one edge on it, only one of their triangles has any area.
+				if (ring != 0) {
+					mesh.indices.insert(mesh.indices.end(), { a, a + 1, b });
+				}
+				if (ring != rings - 1) {
+					mesh.indices.insert(mesh.indices.end(), { a + 1, b + 1, b });
+				}
+			}
+		}
+
+		std::vector<uint32_t> order(mesh.indices.size() / 3);
+		for (uint32_t i = 0; i < order.size(); ++i) {
+			order[i] = i;
+		}
+		std::shuffle(order.begin(), order.end(), std::mt19937{ 42 });
+		std::vector<uint32_t> shuffled;
+		shuffled.reserve(mesh.indices.size());
+		for (uint32_t triangle : order) {
+			shuffled.insert(shuffled.end(), mesh.indices.begin() + triangle * 3, mesh.indices.begin() + triangle * 3 + 3);
+		}
+		mesh.indices = std::move(shuffled);
+		return mesh;
+	}
+
+	// a rippled square of positions, normals and uvs with open borders, in row order.
+	inline auto rippledGrid(uint32_t size) -> SampleMesh
+	{
+		SampleMesh mesh = { .name = "generated rippled grid", .floats_per_vertex = 8 };
+		for (uint32_t y = 0; y <= size; ++y) {
+			for (uint32_t x = 0; x <= size; ++x) {
+				const float u = static_cast<float>(x) / size;
+				const float v = static_cast<float>(y) / size;
+				const float height = 0.03f * std::sin(9.0f * u) * std::cos(7.0f * v);
+				mesh.vertex_data.insert(mesh.vertex_data.end(), { u, height, v, 0.0f, 1.0f, 0.0f, u, v });
+			}
+		}
+		const uint32_t row = size + 1;
+		for (uint32_t y = 0; y < size; ++y) {
+			for (uint32_t x = 0; x < size; ++x) {
+				const uint32_t a = y * row + x;
+				mesh.indices.insert(mesh.indices.end(), { a, a + row, a + 1, a + 1, a + row, a + row + 1 });
+			}
+		}
+		return mesh;
+	}
+
+	// every indexed mesh of the obj, as the loader parses it before any optimisation.
+	inline auto fromObj(const std::filesystem::path& obj_path, std::vector<SampleMesh>& meshes) -> bool
+	{
+		auto parsed = MeshLoader::parseObj(obj_path);
+		if (parsed.HasError()) {
+			std::cerr << "Failed to parse " << obj_path << ": " << parsed.Error() << '\n';
+			return false;
+		}
+		for (MeshVariant& mesh_variant : parsed.Value()) {
+			std::visit([&](auto& mesh) {
+				if constexpr (requires { mesh.index_buffer_data; }) {
+					meshes.emplace_back(SampleMesh{
+						.name = obj_path.filename().string(),
+						.floats_per_vertex = std::decay_t<decltype(mesh)>::floats_per_vertex_attribute,
+						.vertex_data = std::move(mesh.vertex_buffer_data),
+						.indices = std::move(mesh.index_buffer_data) });
+				}
+			}, mesh_variant);
+		}
+		return true;
+	}
+
+	// false when one of the objs couldn't be read, the test should fail rather than quietly check less.
+	inline auto all(std::vector<SampleMesh>& meshes) -> bool
+	{
+		meshes.emplace_back(bumpySphere(48, 96));
+		meshes.emplace_back(rippledGrid(48));
+		bool is_complete = true;
+		for (const char* obj : { "assets/objects/sphere.obj", "assets/objects/bullet.obj", "assets/objects/trail.obj" }) {
+			is_complete &= fromObj(obj, meshes);
+		}
+		return is_complete;
+	}
+}
@@ -0,0 +1,51 @@
+#include "renderer/3d/Mesh.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+
+// Bakes every .obj under a directory into the mesh cache ahead of time, so the first run doesn't pay for parsing.
+// usage: MeshBaker [objects directory = assets/objects] [cache directory = MeshLoader::cache_directory]
+int main(int argc, char* argv[])
+{
+    const std::filesystem::path objects_dir = (argc > 1) ? argv[1] : "assets/objects";
+    const std::filesystem::path cache_dir = (argc > 2) ? std::filesystem::path { argv[2] } : MeshLoader::cache_directory;
+
+    if (!std::filesystem::is_directory(objects_dir)) {
+        std::cerr << objects_dir << " is not a directory." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    size_t baked_count = 0;
+    size_t failed_count = 0;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(objects_dir)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".obj") {
+            continue;
+        }
+        MeshLoader::bakeObj(entry.path(), cache_dir)
+            .OnValue([&](const MeshLoader::BakedObj& baked_obj) {
+                std::cout << entry.path() << " -> " << baked_obj.baked_path << std::endl;
+                for (const MeshLoader::MeshReport& report : baked_obj.reports) {
+                    const MeshOptimiser::Report& optimisation = report.optimisation;
+                    std::cout << "    " << optimisation.before.triangle_count << " triangles"
+                              << ", acmr " << optimisation.before.acmr << " -> " << optimisation.after.acmr
+                              << ", atvr " << optimisation.before.atvr << " -> " << optimisation.after.atvr << std::endl;
+                    std::cout << "    lods:";
+                    for (size_t triangle_count : report.lod_triangle_counts) {
+                        std::cout << " " << triangle_count;
+                    }
+                    std::cout << std::endl;
+                }
+                ++baked_count;
+            })
+            .OnError([&](std::string_view error) {
+                std::cerr << entry.path() << ": " << error << std::endl;
+                ++failed_count;
+            });
+    }
+
+    std::cout << "Baked " << baked_count << " meshes, " << failed_count << " failed." << std::endl;
+    return (failed_count == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}